@@ -0,0 +1,67 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace cilo72
+{
+    namespace fonts
+    {
+        /**
+         * @brief An antialiased font with 8 bit coverage per pixel.
+         *
+         * All glyphs have the same cell size. The glyphs are stored one after the other, each row by row with
+         * one byte per pixel, 0 is transparent and 255 fully covered. The descriptor is a constexpr object,
+         * usually generated together with the data by tools/alpha_font_converter.py.
+         *
+         * The pixels are blended with the background on RGB565 framebuffers, other formats draw the pixels
+         * covered at least by half.
+         */
+        class AlphaFont
+        {
+        public:
+            /**
+             * @brief Create a font descriptor.
+             * @param width The width of a glyph in pixels.
+             * @param height The height of a glyph in pixels.
+             * @param spacing The spacing between characters in pixels.
+             * @param first The ASCII code of the first character.
+             * @param last The ASCII code of the last character.
+             * @param data The coverage of the glyphs, width * height bytes per character.
+             */
+            constexpr AlphaFont(uint8_t width, uint8_t height, uint8_t spacing, uint8_t first, uint8_t last, const uint8_t *data)
+                : data_(data), width_(width), height_(height), spacing_(spacing), first_(first), last_(last)
+            {
+            }
+
+            constexpr uint8_t width() const { return width_; }
+            constexpr uint8_t height() const { return height_; }
+            constexpr uint8_t spacingPerChar() const { return spacing_; }
+            constexpr uint8_t firstAsciiChar() const { return first_; }
+            constexpr uint8_t lastAsciiChar() const { return last_; }
+
+            /**
+             * @brief Get the coverage of a character.
+             * @param c The character.
+             * @return The first row of the glyph or nullptr if the font has no glyph for the character.
+             */
+            constexpr const uint8_t *glyph(char c) const
+            {
+                uint8_t code = c;
+                return code < first_ || code > last_ ? nullptr : data_ + (code - first_) * width_ * height_;
+            }
+
+        private:
+            const uint8_t *data_;
+            uint8_t width_;
+            uint8_t height_;
+            uint8_t spacing_;
+            uint8_t first_;
+            uint8_t last_;
+        };
+    }
+}
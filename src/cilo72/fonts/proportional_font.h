@@ -0,0 +1,154 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace cilo72
+{
+    namespace fonts
+    {
+        /**
+         * @brief A font with a width and an advance per glyph and optionally run length encoded glyph data.
+         *
+         * The glyphs are stored column by column like the fixed width fonts, (height + 7) / 8 bytes per column
+         * with the top row in the least significant bit, but only the columns between the leftmost and the
+         * rightmost set pixel are stored. The glyph table holds the offset of each glyph in the data.
+         *
+         * If the font is compressed, the bytes of each glyph are stored in packets. A packet starts with a byte n.
+         * If bit 7 is set, the next byte is repeated (n & 0x7F) + 1 times, otherwise n + 1 literal bytes follow.
+         *
+         * The descriptor is a constexpr object, tools/bdf_font_converter.py generates it from BDF fonts.
+         */
+        class ProportionalFont
+        {
+        public:
+            /**
+             * @brief The metrics of a glyph.
+             */
+            struct Glyph
+            {
+                uint16_t offset; //< Offset of the first byte in the data.
+                uint8_t width;   //< Number of stored columns.
+                uint8_t advance; //< Distance to the next character.
+                int8_t left;     //< Distance from the pen position to the first stored column.
+            };
+
+            /**
+             * @brief Reads the bytes of a glyph, decoding the packets of compressed fonts.
+             */
+            class Reader
+            {
+            public:
+                constexpr Reader(const ProportionalFont &font, const Glyph &glyph)
+                    : data_(font.data_ + glyph.offset), compressed_(font.compressed_), repeat_(false), count_(0), value_(0)
+                {
+                }
+
+                /**
+                 * @brief Get the next byte of the glyph.
+                 */
+                uint8_t next()
+                {
+                    if (not compressed_)
+                    {
+                        return *data_++;
+                    }
+
+                    if (count_ == 0)
+                    {
+                        uint8_t n = *data_++;
+                        repeat_ = n & 0x80;
+                        count_ = (n & 0x7F) + 1;
+                        if (repeat_)
+                        {
+                            value_ = *data_++;
+                        }
+                    }
+
+                    --count_;
+                    return repeat_ ? value_ : *data_++;
+                }
+
+            private:
+                const uint8_t *data_;
+                bool compressed_;
+                bool repeat_;
+                uint8_t count_;
+                uint8_t value_;
+            };
+
+            /**
+             * @brief Create a font descriptor.
+             * @param height The height of the glyphs in pixels.
+             * @param first The ASCII code of the first character.
+             * @param last The ASCII code of the last character.
+             * @param glyphs The metrics of the characters first to last.
+             * @param data The glyph data.
+             * @param compressed True if the glyph data is run length encoded.
+             */
+            constexpr ProportionalFont(uint8_t height, uint8_t first, uint8_t last, const Glyph *glyphs, const uint8_t *data, bool compressed = false)
+                : glyphs_(glyphs), data_(data), height_(height), first_(first), last_(last), compressed_(compressed)
+            {
+            }
+
+            constexpr uint8_t height() const { return height_; }
+            constexpr uint8_t firstAsciiChar() const { return first_; }
+            constexpr uint8_t lastAsciiChar() const { return last_; }
+            constexpr bool compressed() const { return compressed_; }
+
+            /**
+             * @brief Get the number of bytes per column.
+             */
+            constexpr uint8_t bytesPerColumn() const { return (height_ + 7) / 8; }
+
+            /**
+             * @brief Get the metrics of a character.
+             * @param c The character.
+             * @return The metrics or nullptr if the font has no glyph for the character.
+             */
+            constexpr const Glyph *glyph(char c) const
+            {
+                uint8_t code = c;
+                return code < first_ || code > last_ ? nullptr : &glyphs_[code - first_];
+            }
+
+            /**
+             * @brief Get the distance to the next character.
+             * @param c The character.
+             * @return The advance, 0 if the font has no glyph for the character.
+             */
+            constexpr uint8_t advance(char c) const
+            {
+                uint8_t code = c;
+                return code < first_ || code > last_ ? 0 : glyphs_[code - first_].advance;
+            }
+
+            /**
+             * @brief Get the width of a string in one pass.
+             * @param s The string.
+             * @return The sum of the advances of all characters.
+             */
+            constexpr uint32_t textWidth(const char *s) const
+            {
+                uint32_t width = 0;
+                for (; *s; ++s)
+                {
+                    width += advance(*s);
+                }
+                return width;
+            }
+
+        private:
+            const Glyph *glyphs_;
+            const uint8_t *data_;
+            uint8_t height_;
+            uint8_t first_;
+            uint8_t last_;
+            bool compressed_;
+        };
+    }
+}
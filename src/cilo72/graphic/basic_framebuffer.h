@@ -0,0 +1,164 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <type_traits>
+#include "framebuffer_rgb565.h"
+#include "framebuffer_monochrome.h"
+#include "rasterizer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A framebuffer with compile time pixel format and size.
+     *
+     * The buffer is a member of the object, nothing is allocated on the heap. A monochrome framebuffer also
+     * holds the error row of error diffusion, see FramebufferMonochrome::setDither(). The pixel operations
+     * are inlined into the drawing algorithms, so drawChar(), drawString(), drawSquare() and drawLine()
+     * run without virtual calls per pixel.
+     *
+     * The class derives from the framebuffer of the pixel format and can be passed to the display drivers.
+     *
+     * @tparam Format The pixel format, PixelFormatRGB565 or PixelFormatMonochrome.
+     * @tparam Width The width of the framebuffer.
+     * @tparam Height The height of the framebuffer.
+     */
+    template <class Format, uint16_t Width, uint16_t Height>
+    class BasicFramebuffer final : public Format::Framebuffer
+    {
+    public:
+      using Base = typename Format::Framebuffer;
+      using Base::drawChar;
+      using Base::drawString;
+
+      static_assert(std::is_constructible<Base, uint16_t, uint16_t, uint8_t *>::value,
+                    "the framebuffer of the pixel format needs a constructor with an external buffer");
+
+      BasicFramebuffer() : Base(Width, Height, storage_)
+      {
+        useErrorRow(*this, ditherErrors_);
+      }
+
+      BasicFramebuffer(const BasicFramebuffer &) = delete;
+      BasicFramebuffer &operator=(const BasicFramebuffer &) = delete;
+
+      void clear(const Color &color = Color(0, 0, 0)) override
+      {
+        Format::fillRect(storage_, Width, 0, 0, Width, Height, this->value(color));
+        this->markDirty(Rect(0, 0, Width, Height));
+      }
+
+      void drawSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color) override
+      {
+        Rasterizer::drawSquare(*this, x, y, width, height, color);
+      }
+
+      void drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Color color) override
+      {
+        Rasterizer::drawLine(*this, x1, y1, x2, y2, color);
+      }
+
+      void drawCircle(int32_t cx, int32_t cy, uint32_t radius, Color color)
+      {
+        Rasterizer::drawEllipse(*this, cx, cy, radius, radius, color);
+      }
+
+      void drawEllipse(int32_t cx, int32_t cy, uint32_t rx, uint32_t ry, Color color)
+      {
+        Rasterizer::drawEllipse(*this, cx, cy, rx, ry, color);
+      }
+
+      void drawRoundedSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t radius, Color color)
+      {
+        Rasterizer::drawRoundedSquare(*this, x, y, width, height, radius, color);
+      }
+
+      void drawPolygon(const Point *points, size_t count, Color color)
+      {
+        Rasterizer::drawPolygon(*this, points, count, color);
+      }
+
+      void drawArc(int32_t cx, int32_t cy, uint32_t radius, uint32_t thickness, int32_t startAngle, int32_t endAngle, Color color)
+      {
+        Rasterizer::drawArc(*this, cx, cy, radius, thickness, startAngle, endAngle, color);
+      }
+
+      void drawChar(int32_t x, int32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::Font &font) override
+      {
+        Rasterizer::drawChar(*this, x, y, scale, c, color, font);
+      }
+
+      void drawString(int32_t x, int32_t y, uint32_t scale, const char *s, Color color = Color::white, const cilo72::fonts::Font &font = cilo72::fonts::Font8x5(), Framebuffer::Position position = Framebuffer::TopLeft) override
+      {
+        Rasterizer::drawString(*this, x, y, scale, s, color, font, position);
+      }
+
+      void drawChar(int32_t x, int32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::ProportionalFont &font)
+      {
+        Rasterizer::drawChar(*this, x, y, scale, c, color, font);
+      }
+
+      void drawString(int32_t x, int32_t y, uint32_t scale, const char *s, Color color, const cilo72::fonts::ProportionalFont &font, Framebuffer::Position position = Framebuffer::TopLeft)
+      {
+        Rasterizer::drawString(*this, x, y, scale, s, color, font, position);
+      }
+
+      void drawText(int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Color color, const cilo72::fonts::Font &font)
+      {
+        Rasterizer::drawText(*this, x, y, scale, s, length, color, font);
+      }
+
+      void drawText(int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Color color, const cilo72::fonts::ProportionalFont &font)
+      {
+        Rasterizer::drawText(*this, x, y, scale, s, length, color, font);
+      }
+
+      void blit(int32_t x, int32_t y, const Bitmap &bitmap, Color color = Color::white) override
+      {
+        Rasterizer::blit(*this, x, y, bitmap, color);
+      }
+
+    protected:
+      friend class Rasterizer;
+
+      void setPixel(uint16_t x, uint16_t y, Framebuffer::NativeColor color) override
+      {
+        Format::setPixel(storage_, Width, x, y, color);
+      }
+
+      void fillSpan(uint32_t x, uint32_t y, uint32_t width, Framebuffer::NativeColor color) override
+      {
+        Format::fillSpan(storage_, Width, x, y, width, color);
+      }
+
+      void fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Framebuffer::NativeColor color) override
+      {
+        Format::fillRect(storage_, Width, x, y, width, height, color);
+      }
+
+      void copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height) override
+      {
+        Format::copyRect(storage_, Width, srcX, srcY, dstX, dstY, width, height);
+      }
+
+    private:
+      static void useErrorRow(FramebufferMonochrome &fb, int16_t *errors) { fb.setErrorRow(errors); }
+      static void useErrorRow(Framebuffer &, int16_t *) {}
+
+      alignas(4) uint8_t storage_[Format::bufferSize(Width, Height)];
+      int16_t ditherErrors_[std::is_same<Format, PixelFormatMonochrome>::value ? Width : 1]; //< The error row of error diffusion, only monochrome framebuffers dither.
+    };
+
+    template <uint16_t Width, uint16_t Height>
+    using StaticFramebufferRGB565 = BasicFramebuffer<PixelFormatRGB565, Width, Height>;
+
+    template <uint16_t Width, uint16_t Height>
+    using StaticFramebufferMonochrome = BasicFramebuffer<PixelFormatMonochrome, Width, Height>;
+  }
+}
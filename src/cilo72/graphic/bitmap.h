@@ -0,0 +1,81 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "color.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief An image for Framebuffer::blit(), usually a constant in flash.
+     *
+     * Formats of the data:
+     * - RGB565: width * height pixels row by row, 2 bytes per pixel, high byte first (the byte order of the displays).
+     * - RLE565: RGB565 pixels in packets. A packet starts with a byte n. If bit 7 is set, the next pixel is repeated
+     *   (n & 0x7F) + 1 times, otherwise n + 1 literal pixels follow. Packets continue across rows.
+     * - Monochrome: 1 bit per pixel row by row, each row padded to a full byte, the leftmost pixel in the most
+     *   significant bit. Set bits are drawn in the color passed to blit(), clear bits are transparent.
+     *
+     * Pixels with the value of the color key are transparent. tools/bitmap_converter.py creates bitmaps from images.
+     */
+    class Bitmap
+    {
+    public:
+      enum class Format : uint8_t
+      {
+        RGB565,
+        RLE565,
+        Monochrome,
+      };
+
+      static constexpr uint32_t NO_KEY = UINT32_MAX; //< No transparent color.
+
+      /*!
+       * @brief Create a bitmap.
+       * @param format The format of the data.
+       * @param width The width in pixel.
+       * @param height The height in pixel.
+       * @param data The pixel data, not copied.
+       * @param key The RGB565 value of the transparent color or NO_KEY.
+       */
+      constexpr Bitmap(Format format, uint16_t width, uint16_t height, const uint8_t *data, uint32_t key = NO_KEY)
+          : data_(data), key_(key), width_(width), height_(height), format_(format)
+      {
+      }
+
+      /*!
+       * @brief Get a copy of the bitmap with a transparent color.
+       * @param key The transparent color.
+       */
+      constexpr Bitmap withKey(const Color &key) const
+      {
+        return Bitmap(format_, width_, height_, data_, key.toRGB565(key));
+      }
+
+      constexpr Format format() const { return format_; }
+      constexpr uint16_t width() const { return width_; }
+      constexpr uint16_t height() const { return height_; }
+      constexpr const uint8_t *data() const { return data_; }
+      constexpr uint32_t key() const { return key_; }
+      constexpr bool hasKey() const { return key_ != NO_KEY; }
+
+      /*!
+       * @brief Get the number of bytes per row of a monochrome bitmap.
+       */
+      constexpr uint16_t stride() const { return (width_ + 7) / 8; }
+
+    private:
+      const uint8_t *data_;
+      uint32_t key_;
+      uint16_t width_;
+      uint16_t height_;
+      Format format_;
+    };
+  }
+}
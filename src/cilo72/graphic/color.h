@@ -11,6 +11,12 @@ namespace cilo72
 {
   namespace graphic
   {
+    /*!
+     * @brief A RGB color with 8 bit per channel.
+     *
+     * All operations are constexpr, so conversions of constant colors, e.g. Color::white.toRGB565(Color::white),
+     * are done by the compiler.
+     */
     class Color
     {
     public:
@@ -29,14 +35,19 @@ namespace cilo72
        * @param g The green value.
        * @param b The blue value.
        */
-      Color(uint8_t r, uint8_t g, uint8_t b);
+      constexpr Color(uint8_t r, uint8_t g, uint8_t b) : r_(r), g_(g), b_(b)
+      {
+      }
 
       /*!
        * @brief Compare two colors.
        * @param rhs The color to compare with.
        * @return True if the colors are equal.
        */
-      bool operator==(const Color &rhs) const;
+      constexpr bool operator==(const Color &rhs) const
+      {
+        return r_ == rhs.r_ && g_ == rhs.g_ && b_ == rhs.b_;
+      }
 
       /*!
        * @brief Convert a color to RGB565.
@@ -44,16 +55,39 @@ namespace cilo72
        * @param swapBytes True if the bytes should be swapped.
        * @return The color in RGB565 format.
        */
-      uint16_t toRGB565(const Color &color, bool swapBytes = false) const;
+      constexpr uint16_t toRGB565(const Color &color, bool swapBytes = false) const
+      {
+        uint16_t ret = (color.r_ >> 3) << 11 | (color.g_ >> 2) << 5 | (color.b_ >> 3);
+        return swapBytes ? (uint16_t)((ret >> 8) | (ret << 8)) : ret;
+      }
 
-      uint8_t r() const { return r_; }
-      uint8_t g() const { return g_; }
-      uint8_t b() const { return b_; }
+      /*!
+       * @brief Create a color from a RGB565 value.
+       * @param value The RGB565 value, not swapped.
+       * @return The color, toRGB565() of it returns the value again.
+       */
+      static constexpr Color fromRGB565(uint16_t value)
+      {
+        return Color((value >> 11) << 3 | (value >> 13), ((value >> 5) & 0x3F) << 2 | ((value >> 9) & 0x03), (value & 0x1F) << 3 | ((value >> 2) & 0x07));
+      }
+
+      constexpr uint8_t r() const { return r_; }
+      constexpr uint8_t g() const { return g_; }
+      constexpr uint8_t b() const { return b_; }
 
     protected:
       uint8_t r_;
       uint8_t g_;
       uint8_t b_;
     };
+
+    constexpr Color Color::white    = Color(255, 255, 255);
+    constexpr Color Color::black    = Color(  0,   0,   0);
+    constexpr Color Color::red      = Color(255,   0,   0);
+    constexpr Color Color::green    = Color(  0, 255,   0);
+    constexpr Color Color::blue     = Color(  0,   0, 255);
+    constexpr Color Color::yellow   = Color(255, 255,   0);
+    constexpr Color Color::magenta  = Color(255,   0, 255);
+    constexpr Color Color::cyan     = Color(  0, 255, 255);
   }
 }
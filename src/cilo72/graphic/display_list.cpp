@@ -0,0 +1,245 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <string.h>
+#include "cilo72/graphic/display_list.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    namespace
+    {
+      /*
+       * Sequential reader of the command buffer.
+       */
+      class Reader
+      {
+      public:
+        Reader(const uint8_t *data) : data_(data) {}
+
+        uint8_t get8() { return *data_++; }
+
+        int16_t get16()
+        {
+          int16_t value = (int16_t)(data_[0] | (data_[1] << 8));
+          data_ += 2;
+          return value;
+        }
+
+        Color getColor()
+        {
+          Color color(data_[0], data_[1], data_[2]);
+          data_ += 3;
+          return color;
+        }
+
+        const void *getPointer()
+        {
+          const void *value;
+          memcpy(&value, data_, sizeof(value));
+          data_ += sizeof(value);
+          return value;
+        }
+
+        const char *getString(uint8_t len)
+        {
+          const char *s = (const char *)data_;
+          data_ += len + 1;
+          return s;
+        }
+
+        const uint8_t *position() const { return data_; }
+
+      private:
+        const uint8_t *data_;
+      };
+    }
+
+    DisplayList::DisplayList(uint8_t *buffer, size_t size)
+        : buffer_(buffer), capacity_(size), used_(0), overflow_(false)
+    {
+    }
+
+    void DisplayList::reset()
+    {
+      used_ = 0;
+      overflow_ = false;
+    }
+
+    const cilo72::fonts::Font &DisplayList::defaultFont()
+    {
+      static const cilo72::fonts::Font8x5 font;
+      return font;
+    }
+
+    bool DisplayList::begin(Op op, size_t len)
+    {
+      if (used_ + 1 + len > capacity_)
+      {
+        overflow_ = true;
+        return false;
+      }
+      put8(static_cast<uint8_t>(op));
+      return true;
+    }
+
+    void DisplayList::put8(uint8_t value)
+    {
+      buffer_[used_++] = value;
+    }
+
+    void DisplayList::put16(int16_t value)
+    {
+      buffer_[used_++] = value & 0xFF;
+      buffer_[used_++] = (value >> 8) & 0xFF;
+    }
+
+    void DisplayList::putColor(const Color &color)
+    {
+      put8(color.r());
+      put8(color.g());
+      put8(color.b());
+    }
+
+    bool DisplayList::rect(Op op, int16_t x, int16_t y, int16_t width, int16_t height, const Color &color)
+    {
+      if (not begin(op, 8 + 3))
+      {
+        return false;
+      }
+      put16(x);
+      put16(y);
+      put16(width);
+      put16(height);
+      putColor(color);
+      return true;
+    }
+
+    bool DisplayList::clear(const Color &color)
+    {
+      if (not begin(Op::Clear, 3))
+      {
+        return false;
+      }
+      putColor(color);
+      return true;
+    }
+
+    bool DisplayList::drawPixel(int16_t x, int16_t y, const Color &color)
+    {
+      if (not begin(Op::Pixel, 4 + 3))
+      {
+        return false;
+      }
+      put16(x);
+      put16(y);
+      putColor(color);
+      return true;
+    }
+
+    bool DisplayList::drawSquare(int16_t x, int16_t y, int16_t width, int16_t height, const Color &color)
+    {
+      return rect(Op::Square, x, y, width, height, color);
+    }
+
+    bool DisplayList::drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, const Color &color)
+    {
+      return rect(Op::Line, x1, y1, x2, y2, color);
+    }
+
+    bool DisplayList::drawEmptySquare(int16_t x, int16_t y, int16_t width, int16_t height, const Color &color)
+    {
+      return rect(Op::EmptySquare, x, y, width, height, color);
+    }
+
+    bool DisplayList::drawChar(int16_t x, int16_t y, uint8_t scale, char c, const Color &color, const cilo72::fonts::Font &font)
+    {
+      const char s[2] = {c, 0};
+      return drawString(x, y, scale, s, color, font, Framebuffer::TopLeft);
+    }
+
+    bool DisplayList::drawString(int16_t x, int16_t y, uint8_t scale, const char *s, const Color &color, const cilo72::fonts::Font &font, Framebuffer::Position position)
+    {
+      size_t len = strlen(s);
+      if (len > 255 or not begin(Op::String, 4 + 1 + 3 + sizeof(const void *) + 1 + 1 + len + 1))
+      {
+        return false;
+      }
+      put16(x);
+      put16(y);
+      put8(scale);
+      putColor(color);
+      const cilo72::fonts::Font *f = &font;
+      memcpy(buffer_ + used_, &f, sizeof(f));
+      used_ += sizeof(f);
+      put8(position);
+      put8(len);
+      memcpy(buffer_ + used_, s, len + 1);
+      used_ += len + 1;
+      return true;
+    }
+
+    void DisplayList::replay(Framebuffer &fb, int16_t dx, int16_t dy) const
+    {
+      Reader reader(buffer_);
+      while (reader.position() < buffer_ + used_)
+      {
+        Op op = static_cast<Op>(reader.get8());
+        switch (op)
+        {
+        case Op::Clear:
+          fb.clear(reader.getColor());
+          break;
+
+        case Op::Pixel:
+        {
+          int16_t x = reader.get16() + dx;
+          int16_t y = reader.get16() + dy;
+          fb.drawSquare(x, y, 1, 1, reader.getColor());
+          break;
+        }
+
+        case Op::Square:
+        case Op::Line:
+        case Op::EmptySquare:
+        {
+          int16_t a = reader.get16();
+          int16_t b = reader.get16();
+          int16_t c = reader.get16();
+          int16_t d = reader.get16();
+          Color color = reader.getColor();
+          if (op == Op::Square)
+          {
+            fb.drawSquare(a + dx, b + dy, c, d, color);
+          }
+          else if (op == Op::Line)
+          {
+            fb.drawLine(a + dx, b + dy, c + dx, d + dy, color);
+          }
+          else
+          {
+            fb.drawEmptySquare(a + dx, b + dy, c, d, color);
+          }
+          break;
+        }
+
+        case Op::String:
+        {
+          int16_t x = reader.get16() + dx;
+          int16_t y = reader.get16() + dy;
+          uint8_t scale = reader.get8();
+          Color color = reader.getColor();
+          const cilo72::fonts::Font *font = (const cilo72::fonts::Font *)reader.getPointer();
+          Framebuffer::Position position = static_cast<Framebuffer::Position>(reader.get8());
+          uint8_t len = reader.get8();
+          fb.drawString(x, y, scale, reader.getString(len), color, *font, position);
+          break;
+        }
+        }
+      }
+    }
+  }
+}
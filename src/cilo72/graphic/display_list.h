@@ -0,0 +1,144 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "framebuffer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A compact recording of drawing calls.
+     *
+     * The calls are stored in a byte buffer and can be replayed into any framebuffer, optionally
+     * translated. This allows to render a screen band by band into a small strip buffer,
+     * see cilo72::ic::ST7735S::updateBands().
+     *
+     * Strings are copied into the list. Fonts are referenced, they have to outlive the list.
+     */
+    class DisplayList
+    {
+    public:
+      /*!
+       * @brief Create a display list on existing memory.
+       * @param buffer The memory for the commands.
+       * @param size The size of the memory in bytes.
+       */
+      DisplayList(uint8_t *buffer, size_t size);
+
+      /*!
+       * @brief Remove all commands.
+       */
+      void reset();
+
+      /*!
+       * @brief Get the number of bytes used by the commands.
+       */
+      size_t size() const { return used_; }
+
+      /*!
+       * @brief Check if a command was dropped because the list was full.
+       */
+      bool overflow() const { return overflow_; }
+
+      /*!
+       * @brief Record Framebuffer::clear().
+       * @return False if the list is full.
+       */
+      bool clear(const Color &color = Color(0, 0, 0));
+
+      /*!
+       * @brief Record Framebuffer::drawPixel().
+       * @return False if the list is full.
+       */
+      bool drawPixel(int16_t x, int16_t y, const Color &color);
+
+      /*!
+       * @brief Record Framebuffer::drawSquare().
+       * @return False if the list is full.
+       */
+      bool drawSquare(int16_t x, int16_t y, int16_t width, int16_t height, const Color &color);
+
+      /*!
+       * @brief Record Framebuffer::drawLine().
+       * @return False if the list is full.
+       */
+      bool drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, const Color &color);
+
+      /*!
+       * @brief Record Framebuffer::drawEmptySquare().
+       * @return False if the list is full.
+       */
+      bool drawEmptySquare(int16_t x, int16_t y, int16_t width, int16_t height, const Color &color);
+
+      /*!
+       * @brief Record Framebuffer::drawChar().
+       * @return False if the list is full.
+       */
+      bool drawChar(int16_t x, int16_t y, uint8_t scale, char c, const Color &color, const cilo72::fonts::Font &font);
+
+      /*!
+       * @brief Record Framebuffer::drawString().
+       * @return False if the list is full.
+       */
+      bool drawString(int16_t x, int16_t y, uint8_t scale, const char *s, const Color &color = Color::white, const cilo72::fonts::Font &font = defaultFont(), Framebuffer::Position position = Framebuffer::TopLeft);
+
+      /*!
+       * @brief Execute all commands on a framebuffer.
+       * @param fb The framebuffer.
+       * @param dx Added to all X coordinates.
+       * @param dy Added to all Y coordinates.
+       */
+      void replay(Framebuffer &fb, int16_t dx = 0, int16_t dy = 0) const;
+
+      /*!
+       * @brief The font used if none is given.
+       */
+      static const cilo72::fonts::Font &defaultFont();
+
+    private:
+      enum class Op : uint8_t
+      {
+        Clear,
+        Pixel,
+        Square,
+        Line,
+        EmptySquare,
+        String,
+      };
+
+      uint8_t *buffer_;
+      size_t capacity_;
+      size_t used_;
+      bool overflow_;
+
+      bool begin(Op op, size_t len);
+      void put8(uint8_t value);
+      void put16(int16_t value);
+      void putColor(const Color &color);
+      bool rect(Op op, int16_t x, int16_t y, int16_t width, int16_t height, const Color &color);
+    };
+
+    /*!
+     * @brief A display list with a compile time memory budget.
+     * @tparam Bytes The memory budget in bytes.
+     */
+    template <size_t Bytes>
+    class StaticDisplayList : public DisplayList
+    {
+    public:
+      StaticDisplayList() : DisplayList(storage_, Bytes)
+      {
+      }
+
+    private:
+      uint8_t storage_[Bytes];
+    };
+  }
+}
@@ -7,15 +7,15 @@
 #include <string.h>
 #include <assert.h>
 #include "framebuffer.h"
+#include "rasterizer.h"
 
 namespace cilo72
 {
   namespace graphic
   {
-    Framebuffer::Framebuffer(uint8_t width, uint8_t height, size_t bufferSize)
-        : buffer_(nullptr), bufferSize_(bufferSize), width_(width), height_(height)
+    Framebuffer::Framebuffer(uint16_t width, uint16_t height, uint8_t *buffer, size_t bufferSize)
+        : buffer_(buffer), bufferSize_(bufferSize), width_(width), height_(height), clip_(0, 0, width, height), viewport_(0, 0, width, height), originX_(0), originY_(0), viewportDepth_(0), glyphCache_(nullptr)
     {
-      buffer_ = new uint8_t[bufferSize_];
     }
 
     const uint8_t *Framebuffer::buffer() const
@@ -23,12 +23,12 @@ namespace cilo72
       return buffer_;
     }
 
-    uint8_t Framebuffer::width() const
+    uint16_t Framebuffer::width() const
     {
       return width_;
     }
 
-    uint8_t Framebuffer::height() const
+    uint16_t Framebuffer::height() const
     {
       return height_;
     }
@@ -41,13 +41,86 @@ namespace cilo72
     void Framebuffer::fill(uint8_t value)
     {
       memset(buffer_, value, bufferSize_);
+      markDirty(Rect(0, 0, width_, height_));
+    }
+
+    void Framebuffer::setClipRect(const Rect &rect)
+    {
+      clip_ = Rect(rect.x() + originX_, rect.y() + originY_, rect.width(), rect.height()).intersected(viewport_);
+    }
+
+    void Framebuffer::resetClipRect()
+    {
+      clip_ = viewport_;
+    }
+
+    void Framebuffer::pushViewport(const Rect &rect)
+    {
+      assert(viewportDepth_ < MAX_VIEWPORTS);
+
+      viewports_[viewportDepth_++] = {viewport_, clip_, originX_, originY_};
+      originX_ += rect.x();
+      originY_ += rect.y();
+      viewport_ = Rect(originX_, originY_, rect.width(), rect.height()).intersected(clip_);
+      clip_ = viewport_;
+    }
+
+    void Framebuffer::popViewport()
+    {
+      assert(viewportDepth_ > 0);
+
+      const Viewport &v = viewports_[--viewportDepth_];
+      viewport_ = v.bounds;
+      clip_ = v.clip;
+      originX_ = v.originX;
+      originY_ = v.originY;
+    }
+
+    void Framebuffer::markDirty(const Rect &rect)
+    {
+      dirty_ = dirty_.united(rect.intersected(Rect(0, 0, width_, height_)));
+    }
+
+    void Framebuffer::drawPixel(int32_t x, int32_t y, const Color &color)
+    {
+      x += originX_;
+      y += originY_;
+      if (not clip_.contains(x, y))
+      {
+        return;
+      }
+
+      markDirty(Rect(x, y, 1, 1));
+      setPixel(x, y, nativeColor(color));
     }
 
     void Framebuffer::swap(int32_t *a, int32_t *b)
     {
-      int32_t *t = a;
+      int32_t t = *a;
       *a = *b;
-      *b = *t;
+      *b = t;
+    }
+
+    uint8_t Framebuffer::outCode(int32_t x, int32_t y, const Rect &clip)
+    {
+      uint8_t code = OutCodeInside;
+      if (x < clip.x())
+      {
+        code |= OutCodeLeft;
+      }
+      else if (x >= clip.right())
+      {
+        code |= OutCodeRight;
+      }
+      if (y < clip.y())
+      {
+        code |= OutCodeTop;
+      }
+      else if (y >= clip.bottom())
+      {
+        code |= OutCodeBottom;
+      }
+      return code;
     }
 
     /*!
@@ -61,6 +134,7 @@ namespace cilo72
       {
         assert(0);
       }
+      markDirty(Rect(0, 0, width_, height_));
       return buffer_[index];
     }
 
@@ -78,122 +152,210 @@ namespace cilo72
       return buffer_[index];
     }
 
-    void Framebuffer::drawSquare(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Color color)
+    void Framebuffer::fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color)
     {
       for (uint32_t i = 0; i < width; ++i)
       {
-        for (uint32_t j = 0; j < height; ++j)
-        {
-          drawPixel(x + i, y + j, color);
-        }
+        setPixel(x + i, y, color);
       }
     }
 
-    void Framebuffer::drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Color color)
+    void Framebuffer::fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color)
     {
-      if (x1 > x2)
+      for (uint32_t j = 0; j < height; ++j)
       {
-        swap(&x1, &x2);
-        swap(&y1, &y2);
+        fillSpan(x, y + j, width, color);
       }
+    }
 
-      if (x1 == x2)
+    void Framebuffer::copySpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *rgb565)
+    {
+      uint32_t i = 0;
+      while (i < width)
       {
-        if (y1 > y2)
+        uint16_t value = rgb565[2 * i] << 8 | rgb565[2 * i + 1];
+        uint32_t start = i;
+        for (++i; i < width && (rgb565[2 * i] << 8 | rgb565[2 * i + 1]) == value; ++i)
         {
-          swap(&y1, &y2);
         }
-
-        for (int32_t i = y1; i <= y2; ++i)
-        {
-          drawPixel(x1, i, color);
-        }
-        return;
+        fillSpan(x + start, y, i - start, nativeColor(Color::fromRGB565(value)));
       }
+    }
 
-      float m = (float)(y2 - y1) / (float)(x2 - x1);
-
-      for (int32_t i = x1; i <= x2; ++i)
+    void Framebuffer::blendSpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *alpha, NativeColor color)
+    {
+      uint32_t i = 0;
+      while (i < width)
       {
-        float y = m * (float)(i - x1) + (float)y1;
-        drawPixel(i, (uint32_t)y, color);
+        for (; i < width && alpha[i] < 0x80; ++i)
+        {
+        }
+        uint32_t start = i;
+        for (; i < width && alpha[i] >= 0x80; ++i)
+        {
+        }
+        if (i > start)
+        {
+          fillSpan(x + start, y, i - start, color);
+        }
       }
     }
 
-    void Framebuffer::drawEmptySquare(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Color color)
+    void Framebuffer::blendRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t alpha, NativeColor color)
     {
-      drawLine(x, y, x + width, y, color);
-      drawLine(x, y + height, x + width, y + height, color);
-      drawLine(x, y, x, y + height, color);
-      drawLine(x + width, y, x + width, y + height, color);
+      if (alpha >= 0x80)
+      {
+        fillRect(x, y, width, height, color);
+      }
     }
 
-    void Framebuffer::drawChar(uint32_t x, uint32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::Font &font)
+    void Framebuffer::copyRect(const Rect &src, int32_t x, int32_t y)
     {
-      if (c < font.firstAscciiChar() || c > font.lastAscciiChar())
+      int32_t dx = x - src.x();
+      int32_t dy = y - src.y();
+      Rect s = Rect(src.x() + originX_, src.y() + originY_, src.width(), src.height()).intersected(Rect(0, 0, width_, height_));
+      Rect d = Rect(s.x() + dx, s.y() + dy, s.width(), s.height()).intersected(clip_);
+      if (d.isEmpty())
       {
         return;
       }
 
-      uint32_t parts_per_line = (font.height() >> 3) + ((font.height() & 7) > 0);
-      for (uint8_t w = 0; w < font.width(); ++w)
-      { // width
-        uint32_t pp = (c - font.firstAscciiChar()) * font.width() * parts_per_line + w * parts_per_line;
-        for (uint32_t lp = 0; lp < parts_per_line; ++lp)
+      markDirty(d);
+      copyBlock(d.x() - dx, d.y() - dy, d.x(), d.y(), d.width(), d.height());
+    }
+
+    void Framebuffer::moveRect(const Rect &src, int32_t x, int32_t y, const Color &fill)
+    {
+      copyRect(src, x, y);
+
+      int32_t dx = x - src.x();
+      int32_t dy = y - src.y();
+      int32_t left = src.x() + originX_;
+      int32_t top = src.y() + originY_;
+      int32_t right = left + src.width();
+      int32_t bottom = top + src.height();
+
+      // the uncovered part of the source is a horizontal strip above or below the rows covered by the destination
+      // and a vertical strip beside it
+      int32_t coveredTop = dy > 0 ? (top + dy < bottom ? top + dy : bottom) : top;
+      int32_t coveredBottom = dy > 0 ? bottom : (bottom + dy > top ? bottom + dy : top);
+      int32_t stripLeft = dx > 0 ? left : (right + dx > left ? right + dx : left);
+      int32_t stripRight = dx > 0 ? (left + dx < right ? left + dx : right) : right;
+
+      Rect strips[3] = {
+          Rect(left, top, right - left, coveredTop - top),
+          Rect(left, coveredBottom, right - left, bottom - coveredBottom),
+          Rect(stripLeft, coveredTop, stripRight - stripLeft, coveredBottom - coveredTop),
+      };
+
+      NativeColor native = nativeColor(fill);
+      for (const Rect &strip : strips)
+      {
+        Rect r = strip.intersected(clip_);
+        if (not r.isEmpty())
         {
-          uint8_t line = font.data()[pp];
-
-          for (int8_t j = 0; j < 8; ++j, line >>= 1)
-          {
-            if (line & 1)
-            {
-              drawSquare(x + w * scale, y + ((lp << 3) + j) * scale, scale, scale, color);
-            }
-          }
-          ++pp;
+          markDirty(r);
+          fillRect(r.x(), r.y(), r.width(), r.height(), native);
         }
       }
     }
 
-    void Framebuffer::drawString(uint32_t x, uint32_t y, uint32_t scale, const char *s, Color color, const cilo72::fonts::Font &font, Position position)
+    void Framebuffer::scroll(int32_t dx, int32_t dy, const Color &fill)
     {
-      switch(position)
-      {
-        case TopLeft:
-          break;
-
-          case TopRight:
-          x -= (font.width() * scale * strlen(s) + font.spacingPerChar() * scale * (strlen(s) - 1));
-          break;
-
-        case Center:
-          x -= ((font.width() * scale * strlen(s) + font.spacingPerChar() * scale * (strlen(s) - 1)) / 2);
-          y -= (font.height() * scale) / 2;
-          break;
-
-        case BottomLeft:
-          y -= font.height() * scale;
-          break;
-      
-          case BottomRight:
-          x -= (font.width() * scale * strlen(s) + font.spacingPerChar() * scale * (strlen(s) - 1));
-          y -= font.height() * scale;
-          break;
-
-          case CenterRight:
-          x -= (font.width() * scale * strlen(s) + font.spacingPerChar() * scale * (strlen(s) - 1));
-          y -= (font.height() * scale) / 2;
-          break;
-
-          case CenterLeft:
-          y -= (font.height() * scale) / 2;
-          break;
-      }
-      for (int32_t x_n = x; *s; x_n += (font.width() + font.spacingPerChar()) * scale)
-      {
-        drawChar(x_n, y, scale, *(s++), color, font);
-      }
+      int32_t x = clip_.x() - originX_;
+      int32_t y = clip_.y() - originY_;
+      moveRect(Rect(x, y, clip_.width(), clip_.height()), x + dx, y + dy, fill);
+    }
+
+    void Framebuffer::drawSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color)
+    {
+      Rasterizer::drawSquare(*this, x, y, width, height, color);
+    }
+
+    void Framebuffer::drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Color color)
+    {
+      Rasterizer::drawLine(*this, x1, y1, x2, y2, color);
+    }
+
+    void Framebuffer::drawEmptySquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color)
+    {
+      int32_t right = x + (int32_t)width;
+      int32_t bottom = y + (int32_t)height;
+      drawLine(x, y, right, y, color);
+      drawLine(x, bottom, right, bottom, color);
+      drawLine(x, y, x, bottom, color);
+      drawLine(right, y, right, bottom, color);
+    }
+
+    void Framebuffer::drawCircle(int32_t cx, int32_t cy, uint32_t radius, Color color)
+    {
+      Rasterizer::drawEllipse(*this, cx, cy, radius, radius, color);
+    }
+
+    void Framebuffer::drawEllipse(int32_t cx, int32_t cy, uint32_t rx, uint32_t ry, Color color)
+    {
+      Rasterizer::drawEllipse(*this, cx, cy, rx, ry, color);
+    }
+
+    void Framebuffer::drawRoundedSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t radius, Color color)
+    {
+      Rasterizer::drawRoundedSquare(*this, x, y, width, height, radius, color);
+    }
+
+    void Framebuffer::drawPolygon(const Point *points, size_t count, Color color)
+    {
+      assert(count <= MAX_POLYGON_VERTICES);
+      Rasterizer::drawPolygon(*this, points, count, color);
     }
 
+    void Framebuffer::drawArc(int32_t cx, int32_t cy, uint32_t radius, uint32_t thickness, int32_t startAngle, int32_t endAngle, Color color)
+    {
+      Rasterizer::drawArc(*this, cx, cy, radius, thickness, startAngle, endAngle, color);
+    }
+
+    void Framebuffer::drawChar(int32_t x, int32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::Font &font)
+    {
+      Rasterizer::drawChar(*this, x, y, scale, c, color, font);
+    }
+
+    void Framebuffer::drawString(int32_t x, int32_t y, uint32_t scale, const char *s, Color color, const cilo72::fonts::Font &font, Position position)
+    {
+      Rasterizer::drawString(*this, x, y, scale, s, color, font, position);
+    }
+
+    void Framebuffer::drawChar(int32_t x, int32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::ProportionalFont &font)
+    {
+      Rasterizer::drawChar(*this, x, y, scale, c, color, font);
+    }
+
+    void Framebuffer::drawString(int32_t x, int32_t y, uint32_t scale, const char *s, Color color, const cilo72::fonts::ProportionalFont &font, Position position)
+    {
+      Rasterizer::drawString(*this, x, y, scale, s, color, font, position);
+    }
+
+    void Framebuffer::drawText(int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Color color, const cilo72::fonts::Font &font)
+    {
+      Rasterizer::drawText(*this, x, y, scale, s, length, color, font);
+    }
+
+    void Framebuffer::drawText(int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Color color, const cilo72::fonts::ProportionalFont &font)
+    {
+      Rasterizer::drawText(*this, x, y, scale, s, length, color, font);
+    }
+
+    void Framebuffer::drawString(int32_t x, int32_t y, const char *s, const cilo72::fonts::AlphaFont &font, Color color, Position position)
+    {
+      Rasterizer::drawString(*this, x, y, s, font, color, position);
+    }
+
+    void Framebuffer::blendSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color, uint8_t alpha)
+    {
+      Rasterizer::blendSquare(*this, x, y, width, height, color, alpha);
+    }
+
+    void Framebuffer::blit(int32_t x, int32_t y, const Bitmap &bitmap, Color color)
+    {
+      Rasterizer::blit(*this, x, y, bitmap, color);
+    }
   }
-}
\ No newline at end of file
+}
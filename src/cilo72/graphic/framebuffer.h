@@ -8,7 +8,12 @@
 #include <stdint.h>
 #include <string.h>
 #include "cilo72/fonts/font_8x5.h"
+#include "cilo72/fonts/alpha_font.h"
+#include "cilo72/fonts/proportional_font.h"
 #include "color.h"
+#include "rect.h"
+#include "glyph_cache.h"
+#include "bitmap.h"
 
 namespace cilo72
 {
@@ -27,15 +32,53 @@ namespace cilo72
         CenterLeft,
         CenterRight
       };
-      Framebuffer(uint8_t width, uint8_t height, size_t bufferSize);
+
+      /*!
+       * @brief The clockwise rotation of the framebuffer content on a display.
+       *
+       * The drawing functions always use the coordinates of the framebuffer, the display drivers rotate while
+       * transferring. With Rotate90 and Rotate270 the framebuffer has the size of the display transposed,
+       * e.g. 128x160 for a 160x128 display.
+       */
+      enum Rotation
+      {
+        Rotate0,
+        Rotate90,
+        Rotate180,
+        Rotate270
+      };
+      /*!
+       * @brief Create a new framebuffer.
+       * @param width The width of the framebuffer.
+       * @param height The height of the framebuffer.
+       * @param buffer The pixel buffer, owned by the derived class.
+       * @param bufferSize The size of the pixel buffer in bytes.
+       */
+      Framebuffer(uint16_t width, uint16_t height, uint8_t *buffer, size_t bufferSize);
+      /*!
+       * @brief A color in the pixel format of the framebuffer, see nativeColor().
+       */
+      using NativeColor = uint32_t;
+
       virtual void clear(const Color &color = Color(0, 0, 0)) = 0;
 
+      /*!
+       * @brief Convert a color to the pixel format of the framebuffer.
+       *
+       * The drawing functions convert their color once per primitive and pass the native value to the
+       * pixel operations.
+       *
+       * @param color The color.
+       * @return The native value, e.g. the RGB565 value or the palette index.
+       */
+      virtual NativeColor nativeColor(const Color &color) const = 0;
+
       /**
        * @brief Draw a pixel on the display.
-       * @param x The X coordinate.
-       * @param y The Y coordinate.
+       * @param x The X coordinate, pixels outside the clip rectangle are ignored.
+       * @param y The Y coordinate, pixels outside the clip rectangle are ignored.
        */
-      virtual void drawPixel(uint8_t x, uint8_t y, const Color &color) = 0;
+      void drawPixel(int32_t x, int32_t y, const Color &color);
 
       /*!
        * @brief Get the framebuffer.
@@ -47,13 +90,13 @@ namespace cilo72
        * @brief Get the width of the framebuffer.
        * @return The width of the framebuffer.
        */
-      uint8_t width() const;
+      uint16_t width() const;
 
       /*!
        * @brief Get the height of the framebuffer.
        * @return The height of the framebuffer.
        */
-      uint8_t height() const;
+      uint16_t height() const;
 
       /*!
        * @brief Get the size of the framebuffer in bytes.
@@ -68,12 +111,88 @@ namespace cilo72
        */
       void fill(uint8_t value);
 
+      /*!
+       * @brief Restrict all drawing functions to a rectangle.
+       * @param rect The clip rectangle relative to the current viewport. It is clipped to the viewport.
+       */
+      void setClipRect(const Rect &rect);
+
+      /*!
+       * @brief Reset the clip rectangle to the current viewport.
+       */
+      void resetClipRect();
+
+      /*!
+       * @brief Get the clip rectangle.
+       * @return The clip rectangle in framebuffer coordinates.
+       */
+      const Rect &clipRect() const { return clip_; }
+
+      /*!
+       * @brief Enter a sub-region of the framebuffer.
+       *
+       * The origin of all drawing functions moves to the top-left corner of the rectangle and drawing is
+       * clipped to it. Viewports nest, the rectangle is relative to the current viewport and clipped by the
+       * current clip rectangle. The offset and clipping are applied once per primitive.
+       *
+       * @param rect The viewport relative to the current viewport.
+       * @warning More than MAX_VIEWPORTS nested viewports will result in an assert!
+       */
+      void pushViewport(const Rect &rect);
+
+      /*!
+       * @brief Leave the current viewport and restore the origin and clip rectangle before pushViewport().
+       * @warning Popping without a pushed viewport will result in an assert!
+       */
+      void popViewport();
+
+      /*!
+       * @brief Get the X coordinate of the current origin in framebuffer coordinates.
+       */
+      int16_t originX() const { return originX_; }
+
+      /*!
+       * @brief Get the Y coordinate of the current origin in framebuffer coordinates.
+       */
+      int16_t originY() const { return originY_; }
+
+      /*!
+       * @brief Use a glyph cache for drawChar() and drawString().
+       * @param cache The cache or nullptr to rasterize every glyph from the font data.
+       */
+      void setGlyphCache(GlyphCache *cache) { glyphCache_ = cache; }
+
+      /*!
+       * @brief Get the region modified since the last call of clearDirty().
+       * @return The bounding rectangle of all modified pixels, empty if nothing was modified.
+       */
+      const Rect &dirtyRegion() const { return dirty_; }
+
+      /*!
+       * @brief Check if any pixel was modified since the last call of clearDirty().
+       * @return True if the dirty region is not empty.
+       */
+      bool isDirty() const { return not dirty_.isEmpty(); }
+
+      /*!
+       * @brief Add a rectangle to the dirty region.
+       * @param rect The modified rectangle. It is clipped to the framebuffer.
+       * @note Only needed if the buffer is modified directly through operator[] or buffer().
+       */
+      virtual void markDirty(const Rect &rect);
+
+      /*!
+       * @brief Reset the dirty region, e.g. after the display was updated.
+       */
+      virtual void clearDirty() { dirty_ = Rect(); }
+
       /*!
        * @brief Overload of the [] operator to access a pixel in the framebuffer.
        *
        * @param index The index of the pixel.
        * @return The pixel at the given index.
        * @warning An out of bounds index will result in an assert!
+       * @note The whole framebuffer is marked as dirty, because the modified pixel is not known.
        */
       uint8_t &operator[](size_t index);
 
@@ -94,17 +213,21 @@ namespace cilo72
        * @param width The width of the square.
        * @param height The height of the square.
        */
-      void drawSquare(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Color color);
+      virtual void drawSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color);
 
       /**
        * @brief Draw a line on the display.
        *
+       * The line is rasterized with integer arithmetic only, consecutive pixels in a row (or column) are
+       * drawn as one span. Clipping limits the rasterized range without moving the end points, so the
+       * visible pixels do not depend on the clip rectangle.
+       *
        * @param x1 The starting X coordinate.
        * @param y1 The starting Y coordinate.
        * @param x2 The ending X coordinate.
        * @param y2 The ending Y coordinate.
        */
-      void drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Color color);
+      virtual void drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Color color);
 
       /**
        * @brief Draw an empty square on the display.
@@ -114,7 +237,68 @@ namespace cilo72
        * @param width The width of the square.
        * @param height The height of the square.
        */
-      void drawEmptySquare(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Color color);
+      void drawEmptySquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color);
+
+      /**
+       * @brief Draw a filled circle.
+       *
+       * The shapes below are filled with horizontal spans computed with integer arithmetic only, no pixel is
+       * drawn twice.
+       *
+       * @param cx The X coordinate of the center pixel.
+       * @param cy The Y coordinate of the center pixel.
+       * @param radius The radius, the circle is 2 * radius + 1 pixels wide.
+       */
+      void drawCircle(int32_t cx, int32_t cy, uint32_t radius, Color color);
+
+      /**
+       * @brief Draw a filled ellipse.
+       *
+       * @param cx The X coordinate of the center pixel.
+       * @param cy The Y coordinate of the center pixel.
+       * @param rx The horizontal radius, the ellipse is 2 * rx + 1 pixels wide.
+       * @param ry The vertical radius, the ellipse is 2 * ry + 1 pixels high.
+       */
+      void drawEllipse(int32_t cx, int32_t cy, uint32_t rx, uint32_t ry, Color color);
+
+      /**
+       * @brief Draw a filled square with rounded corners.
+       *
+       * @param x The X coordinate of the top-left corner of the square.
+       * @param y The Y coordinate of the top-left corner of the square.
+       * @param width The width of the square.
+       * @param height The height of the square.
+       * @param radius The radius of the corners, limited to half the width and height.
+       */
+      void drawRoundedSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t radius, Color color);
+
+      /**
+       * @brief Draw a filled polygon.
+       *
+       * The polygon may be concave or self-intersecting, a pixel is filled if a ray from it crosses the outline
+       * an odd number of times. Pixels on the left and top edges are filled, pixels on the right and bottom
+       * edges are not, so polygons sharing an edge do not overlap and the square (0, 0), (4, 0), (4, 4), (0, 4)
+       * covers the same pixels as drawSquare(0, 0, 4, 4).
+       *
+       * @param points The vertices, at most MAX_POLYGON_VERTICES.
+       * @param count The number of vertices.
+       */
+      void drawPolygon(const Point *points, size_t count, Color color);
+
+      /**
+       * @brief Draw a filled arc, e.g. the track or the value of a round gauge.
+       *
+       * The angles are in degrees, 0 points to the right and the angle grows clockwise on the screen.
+       * The arc is drawn from startAngle to endAngle, 360 degrees or more draw a ring.
+       *
+       * @param cx The X coordinate of the center pixel.
+       * @param cy The Y coordinate of the center pixel.
+       * @param radius The outer radius.
+       * @param thickness The width of the arc, a thickness of at least the radius draws a pie slice.
+       * @param startAngle The start angle.
+       * @param endAngle The end angle, nothing is drawn if it is not greater than startAngle.
+       */
+      void drawArc(int32_t cx, int32_t cy, uint32_t radius, uint32_t thickness, int32_t startAngle, int32_t endAngle, Color color);
 
       /**
        * @brief Draw a character on the display.
@@ -125,7 +309,7 @@ namespace cilo72
        * @param c The character to draw.
        * @param font The font to use. Default is cilo72::fonts::Font8x5().
        */
-      void drawChar(uint32_t x, uint32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::Font &font);
+      virtual void drawChar(int32_t x, int32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::Font &font);
 
       /**
        * @brief Draw a string on the display.
@@ -136,15 +320,246 @@ namespace cilo72
        * @param s The string to draw.
        * @param font The font to use. Default is cilo72::fonts::Font8x5().
        */
-      void drawString(uint32_t x, uint32_t y, uint32_t scale, const char *s, Color color = Color::white, const cilo72::fonts::Font &font = cilo72::fonts::Font8x5(), Position position = TopLeft);  
+      virtual void drawString(int32_t x, int32_t y, uint32_t scale, const char *s, Color color = Color::white, const cilo72::fonts::Font &font = cilo72::fonts::Font8x5(), Position position = TopLeft);  
+
+      /**
+       * @brief Draw a character of a proportional font.
+       *
+       * @param x The X coordinate of the pen position.
+       * @param y The Y coordinate.
+       * @param scale The character scaling factor.
+       * @param c The character to draw.
+       * @param font The font to use.
+       */
+      void drawChar(int32_t x, int32_t y, uint32_t scale, char c, Color color, const cilo72::fonts::ProportionalFont &font);
+
+      /**
+       * @brief Draw a string with a proportional font.
+       *
+       * The characters are placed with the advance of each glyph. The width of the string is only measured
+       * for right aligned and centered positions.
+       *
+       * @param x The X coordinate.
+       * @param y The Y coordinate.
+       * @param scale The character scaling factor.
+       * @param s The string to draw.
+       * @param font The font to use.
+       */
+      void drawString(int32_t x, int32_t y, uint32_t scale, const char *s, Color color, const cilo72::fonts::ProportionalFont &font, Position position = TopLeft);
+
+      /**
+       * @brief Draw the first characters of a string without measuring and aligning it.
+       *
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param scale The character scaling factor.
+       * @param s The string.
+       * @param length The maximum number of characters, drawing also stops at the end of the string.
+       * @param font The font to use.
+       * @see TextLayout
+       */
+      void drawText(int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Color color, const cilo72::fonts::Font &font);
+
+      /**
+       * @brief Draw the first characters of a string with a proportional font without measuring and aligning it.
+       *
+       * @param x The X coordinate of the pen position.
+       * @param y The Y coordinate of the top-left corner.
+       * @param scale The character scaling factor.
+       * @param s The string.
+       * @param length The maximum number of characters, drawing also stops at the end of the string.
+       * @param font The font to use.
+       * @see TextLayout
+       */
+      void drawText(int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Color color, const cilo72::fonts::ProportionalFont &font);
+
+      /**
+       * @brief Draw a string with an antialiased font.
+       *
+       * The glyphs are blended with the background on RGB565 framebuffers.
+       *
+       * @param x The X coordinate.
+       * @param y The Y coordinate.
+       * @param s The string to draw.
+       * @param font The font to use.
+       */
+      void drawString(int32_t x, int32_t y, const char *s, const cilo72::fonts::AlphaFont &font, Color color = Color::white, Position position = TopLeft);
+
+      /**
+       * @brief Draw a translucent filled square.
+       *
+       * @param x The X coordinate of the top-left corner of the square.
+       * @param y The Y coordinate of the top-left corner of the square.
+       * @param width The width of the square.
+       * @param height The height of the square.
+       * @param alpha The opacity, 255 is the same as drawSquare(). Framebuffers without blending draw the square
+       *              if the opacity is at least 128.
+       */
+      void blendSquare(int32_t x, int32_t y, uint32_t width, uint32_t height, Color color, uint8_t alpha);
+
+      /**
+       * @brief Draw a bitmap.
+       *
+       * The bitmap is decoded row by row into spans, pixels of the color key are skipped.
+       *
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param bitmap The bitmap.
+       * @param color The color of the set pixels of a monochrome bitmap, not used for color bitmaps.
+       */
+      virtual void blit(int32_t x, int32_t y, const Bitmap &bitmap, Color color = Color::white);
+
+      /**
+       * @brief Copy a rectangle of pixels to another position in the framebuffer.
+       *
+       * The rows are copied with block moves of the pixel format, source and destination may overlap.
+       *
+       * @param src The source rectangle. Only the part inside the framebuffer is copied.
+       * @param x The X coordinate of the top-left corner of the destination.
+       * @param y The Y coordinate of the top-left corner of the destination.
+       * @note The destination is clipped to the clip rectangle.
+       */
+      void copyRect(const Rect &src, int32_t x, int32_t y);
+
+      /**
+       * @brief Move a rectangle of pixels and fill the uncovered part of the source.
+       *
+       * @param src The source rectangle.
+       * @param x The X coordinate of the top-left corner of the destination.
+       * @param y The Y coordinate of the top-left corner of the destination.
+       * @param fill The color of the source pixels not covered by the destination.
+       */
+      void moveRect(const Rect &src, int32_t x, int32_t y, const Color &fill = Color(0, 0, 0));
+
+      /**
+       * @brief Scroll the content of the clip rectangle.
+       *
+       * E.g. scroll(-1, 0) moves a chart one pixel to the left, only the new column has to be drawn.
+       *
+       * @param dx The horizontal distance, positive values scroll to the right.
+       * @param dy The vertical distance, positive values scroll down.
+       * @param fill The color of the pixels scrolled in.
+       */
+      void scroll(int32_t dx, int32_t dy, const Color &fill = Color(0, 0, 0));
+
+      static constexpr uint8_t MAX_VIEWPORTS = 8; //< Maximum nesting depth of pushViewport().
+      static constexpr uint8_t MAX_POLYGON_VERTICES = 16; //< Maximum number of vertices of drawPolygon().
 
     protected:
+      friend class Rasterizer;
+
+      struct Viewport
+      {
+        Rect bounds;
+        Rect clip;
+        int16_t originX;
+        int16_t originY;
+      };
+
       uint8_t *buffer_;
       uint32_t bufferSize_;
-      uint8_t width_;
-      uint8_t height_;
+      uint16_t width_;
+      uint16_t height_;
+      Rect dirty_;
+      Rect clip_;
+      Rect viewport_;
+      int16_t originX_;
+      int16_t originY_;
+      uint8_t viewportDepth_;
+      Viewport viewports_[MAX_VIEWPORTS];
+      GlyphCache *glyphCache_;
+
+      /**
+       * @brief Set a pixel in the buffer without updating the dirty region.
+       * @param x The X coordinate.
+       * @param y The Y coordinate.
+       * @param color The native color, see nativeColor().
+       */
+      virtual void setPixel(uint16_t x, uint16_t y, NativeColor color) = 0;
+
+      /**
+       * @brief Fill a horizontal span without updating the dirty region.
+       * @param x The X coordinate of the first pixel.
+       * @param y The Y coordinate.
+       * @param width The number of pixels.
+       * @note The span must lie inside the framebuffer. The default implementation calls setPixel() per pixel,
+       *       framebuffer formats override it with a native implementation.
+       */
+      virtual void fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color);
+
+      /**
+       * @brief Fill a rectangle without updating the dirty region.
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param width The width of the rectangle.
+       * @param height The height of the rectangle.
+       * @note The rectangle must lie inside the framebuffer. The default implementation calls fillSpan() per row,
+       *       framebuffer formats override it with a native implementation.
+       */
+      virtual void fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color);
+
+      /**
+       * @brief Copy RGB565 pixels into a horizontal span without updating the dirty region.
+       * @param x The X coordinate of the first pixel.
+       * @param y The Y coordinate.
+       * @param width The number of pixels.
+       * @param rgb565 The pixels, 2 bytes each, high byte first.
+       * @note The span must lie inside the framebuffer. The default implementation converts each run of equal
+       *       pixels with nativeColor() and calls fillSpan().
+       */
+      virtual void copySpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *rgb565);
+
+      /**
+       * @brief Blend a color over a horizontal span without updating the dirty region.
+       * @param x The X coordinate of the first pixel.
+       * @param y The Y coordinate.
+       * @param width The number of pixels.
+       * @param alpha The coverage of each pixel, 0 - 255.
+       * @note The span must lie inside the framebuffer. The default implementation fills the pixels with a
+       *       coverage of at least 128.
+       */
+      virtual void blendSpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *alpha, NativeColor color);
+
+      /**
+       * @brief Blend a color over a rectangle without updating the dirty region.
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param width The width of the rectangle.
+       * @param height The height of the rectangle.
+       * @param alpha The opacity, 0 - 255.
+       * @note The rectangle must lie inside the framebuffer. The default implementation fills the rectangle if
+       *       the opacity is at least 128.
+       */
+      virtual void blendRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t alpha, NativeColor color);
+
+      /**
+       * @brief Copy a block of pixels inside the buffer without updating the dirty region.
+       * @param srcX The X coordinate of the top-left corner of the source.
+       * @param srcY The Y coordinate of the top-left corner of the source.
+       * @param dstX The X coordinate of the top-left corner of the destination.
+       * @param dstY The Y coordinate of the top-left corner of the destination.
+       * @param width The width of the block.
+       * @param height The height of the block.
+       * @note Both blocks must lie inside the framebuffer, they may overlap.
+       */
+      virtual void copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height) = 0;
 
       static void swap(int32_t *a, int32_t *b);
+
+      enum OutCode
+      {
+        OutCodeInside = 0,
+        OutCodeLeft = 1,
+        OutCodeRight = 2,
+        OutCodeTop = 4,
+        OutCodeBottom = 8
+      };
+
+      /**
+       * @brief Get the Cohen-Sutherland out code of a point.
+       */
+      static uint8_t outCode(int32_t x, int32_t y, const Rect &clip);
+
     };
   }
 }
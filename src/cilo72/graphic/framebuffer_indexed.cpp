@@ -0,0 +1,188 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <assert.h>
+#include "cilo72/graphic/framebuffer_indexed.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+      FramebufferIndexed::FramebufferIndexed(uint16_t width, uint16_t height, uint8_t bits)
+          : Framebuffer(width, height, new uint8_t[requiredSize(width, height, bits)], requiredSize(width, height, bits))
+          , bits_(bits)
+          , stride_((width * bits + 7) / 8)
+          , swapBytes_(false)
+          , lut_(new uint16_t[1 << bits])
+          , lastColor_(0, 0, 0)
+          , lastIndex_(-1)
+      {
+        assert(bits == 2 || bits == 4 || bits == 8);
+        memset(lut_, 0, colors() * sizeof(uint16_t));
+      }
+
+      uint32_t FramebufferIndexed::requiredSize(uint16_t width, uint16_t height, uint8_t bits)
+      {
+        return (width * bits + 7) / 8 * height;
+      }
+
+      void FramebufferIndexed::setPalette(uint8_t index, const Color &color)
+      {
+        assert(index < colors());
+        lut_[index] = color.toRGB565(color, swapBytes_);
+        lastIndex_ = -1;
+      }
+
+      void FramebufferIndexed::setPalette(const Color *palette, uint16_t count)
+      {
+        assert(count <= colors());
+        for (uint16_t i = 0; i < count; ++i)
+        {
+          setPalette(i, palette[i]);
+        }
+      }
+
+      void FramebufferIndexed::setSwapBytes(bool swapBytes)
+      {
+        if (swapBytes != swapBytes_)
+        {
+          for (uint16_t i = 0; i < colors(); ++i)
+          {
+            lut_[i] = (lut_[i] >> 8) | (lut_[i] << 8);
+          }
+          swapBytes_ = swapBytes;
+        }
+      }
+
+      uint8_t FramebufferIndexed::value(const Color &color) const
+      {
+        if (lastIndex_ >= 0 && color == lastColor_)
+        {
+          return lastIndex_;
+        }
+
+        uint16_t target = color.toRGB565(color, false);
+        uint32_t bestDistance = UINT32_MAX;
+        uint8_t best = 0;
+        for (uint16_t i = 0; i < colors() && bestDistance > 0; ++i)
+        {
+          uint16_t entry = swapBytes_ ? (lut_[i] >> 8) | (lut_[i] << 8) : lut_[i];
+          int32_t dr = ((entry >> 11) - (target >> 11)) * 2;
+          int32_t dg = ((entry >> 5) & 0x3F) - ((target >> 5) & 0x3F);
+          int32_t db = ((entry & 0x1F) - (target & 0x1F)) * 2;
+          uint32_t distance = dr * dr + dg * dg + db * db;
+          if (distance < bestDistance)
+          {
+            bestDistance = distance;
+            best = i;
+          }
+        }
+
+        lastColor_ = color;
+        lastIndex_ = best;
+        return best;
+      }
+
+      void FramebufferIndexed::toRGB565(uint16_t x, uint16_t y, uint16_t count, uint16_t *dst) const
+      {
+        const uint8_t *p = buffer_ + y * stride_ + x * bits_ / 8;
+        if (bits_ == 8)
+        {
+          for (uint16_t i = 0; i < count; ++i)
+          {
+            dst[i] = lut_[p[i]];
+          }
+          return;
+        }
+
+        uint8_t mask = (1 << bits_) - 1;
+        uint8_t first = 8 - bits_;
+        uint8_t shift = first - (x * bits_ & 7);
+        for (uint16_t i = 0; i < count; ++i)
+        {
+          dst[i] = lut_[(*p >> shift) & mask];
+          if (shift == 0)
+          {
+            shift = first;
+            ++p;
+          }
+          else
+          {
+            shift -= bits_;
+          }
+        }
+      }
+
+      void FramebufferIndexed::clear(const Color &color)
+      {
+        fillRect(0, 0, width_, height_, value(color));
+        markDirty(Rect(0, 0, width_, height_));
+      }
+
+      void FramebufferIndexed::setPixel(uint16_t x, uint16_t y, NativeColor color)
+      {
+        switch (bits_)
+        {
+        case 2:
+          PixelFormatIndexed<2>::setPixel(buffer_, width_, x, y, color);
+          break;
+        case 4:
+          PixelFormatIndexed<4>::setPixel(buffer_, width_, x, y, color);
+          break;
+        default:
+          PixelFormatIndexed<8>::setPixel(buffer_, width_, x, y, color);
+          break;
+        }
+      }
+
+      void FramebufferIndexed::fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color)
+      {
+        switch (bits_)
+        {
+        case 2:
+          PixelFormatIndexed<2>::fillSpan(buffer_, width_, x, y, width, color);
+          break;
+        case 4:
+          PixelFormatIndexed<4>::fillSpan(buffer_, width_, x, y, width, color);
+          break;
+        default:
+          PixelFormatIndexed<8>::fillSpan(buffer_, width_, x, y, width, color);
+          break;
+        }
+      }
+
+      void FramebufferIndexed::fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color)
+      {
+        switch (bits_)
+        {
+        case 2:
+          PixelFormatIndexed<2>::fillRect(buffer_, width_, x, y, width, height, color);
+          break;
+        case 4:
+          PixelFormatIndexed<4>::fillRect(buffer_, width_, x, y, width, height, color);
+          break;
+        default:
+          PixelFormatIndexed<8>::fillRect(buffer_, width_, x, y, width, height, color);
+          break;
+        }
+      }
+
+      void FramebufferIndexed::copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height)
+      {
+        switch (bits_)
+        {
+        case 2:
+          PixelFormatIndexed<2>::copyRect(buffer_, width_, srcX, srcY, dstX, dstY, width, height);
+          break;
+        case 4:
+          PixelFormatIndexed<4>::copyRect(buffer_, width_, srcX, srcY, dstX, dstY, width, height);
+          break;
+        default:
+          PixelFormatIndexed<8>::copyRect(buffer_, width_, srcX, srcY, dstX, dstY, width, height);
+          break;
+        }
+      }
+  }
+}
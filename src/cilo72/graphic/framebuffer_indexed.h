@@ -0,0 +1,227 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "framebuffer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief Pixel operations of a packed palette framebuffer.
+     *
+     * Each row starts at a byte boundary, the leftmost pixel of a byte is stored in the most significant bits.
+     * The bits per pixel are chosen at run time by FramebufferIndexed, so there is no BasicFramebuffer of this format.
+     *
+     * @tparam Bits Bits per pixel, 2, 4 or 8.
+     */
+    template <uint8_t Bits>
+    struct PixelFormatIndexed
+    {
+      using Value = uint8_t;
+
+      static constexpr uint8_t PIXELS_PER_BYTE = 8 / Bits;
+      static constexpr uint8_t MASK = (1 << Bits) - 1;
+
+      static constexpr uint32_t stride(uint32_t width) { return (width * Bits + 7) / 8; }
+      static constexpr size_t bufferSize(uint32_t width, uint32_t height) { return stride(width) * height; }
+
+      static void setPixel(uint8_t *buffer, uint32_t width, uint32_t x, uint32_t y, Value value)
+      {
+        uint8_t *p = buffer + y * stride(width) + x / PIXELS_PER_BYTE;
+        uint8_t shift = (PIXELS_PER_BYTE - 1 - x % PIXELS_PER_BYTE) * Bits;
+        *p = (*p & ~(MASK << shift)) | ((value & MASK) << shift);
+      }
+
+      static Value getPixel(const uint8_t *buffer, uint32_t width, uint32_t x, uint32_t y)
+      {
+        const uint8_t *p = buffer + y * stride(width) + x / PIXELS_PER_BYTE;
+        return (*p >> ((PIXELS_PER_BYTE - 1 - x % PIXELS_PER_BYTE) * Bits)) & MASK;
+      }
+
+      static void fillSpan(uint8_t *buffer, uint32_t width, uint32_t x, uint32_t y, uint32_t count, Value value)
+      {
+        for (; count > 0 && x % PIXELS_PER_BYTE; --count)
+        {
+          setPixel(buffer, width, x++, y, value);
+        }
+
+        uint32_t bytes = count / PIXELS_PER_BYTE;
+        memset(buffer + y * stride(width) + x / PIXELS_PER_BYTE, pattern(value), bytes);
+        x += bytes * PIXELS_PER_BYTE;
+
+        for (count -= bytes * PIXELS_PER_BYTE; count > 0; --count)
+        {
+          setPixel(buffer, width, x++, y, value);
+        }
+      }
+
+      static void fillRect(uint8_t *buffer, uint32_t width, uint32_t x, uint32_t y, uint32_t w, uint32_t h, Value value)
+      {
+        if (x == 0 && w == width && w % PIXELS_PER_BYTE == 0)
+        {
+          memset(buffer + y * stride(width), pattern(value), stride(width) * h);
+          return;
+        }
+
+        for (uint32_t j = 0; j < h; ++j)
+        {
+          fillSpan(buffer, width, x, y + j, w, value);
+        }
+      }
+
+      /*!
+       * @brief Copy a block of pixels, the blocks may overlap.
+       *
+       * Rows with the same position within their bytes are moved with memmove, other rows pixel by pixel.
+       */
+      static void copyRect(uint8_t *buffer, uint32_t width, uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t w, uint32_t h)
+      {
+        bool bottomUp = dstY > srcY;
+        bool rightToLeft = dstX > srcX;
+        bool aligned = srcX % PIXELS_PER_BYTE == 0 && dstX % PIXELS_PER_BYTE == 0 && w % PIXELS_PER_BYTE == 0;
+        for (uint32_t j = 0; j < h; ++j)
+        {
+          // bottom up and right to left if the destination follows the source
+          uint32_t row = bottomUp ? h - 1 - j : j;
+          if (aligned)
+          {
+            memmove(buffer + (dstY + row) * stride(width) + dstX / PIXELS_PER_BYTE,
+                    buffer + (srcY + row) * stride(width) + srcX / PIXELS_PER_BYTE, w / PIXELS_PER_BYTE);
+            continue;
+          }
+
+          for (uint32_t i = 0; i < w; ++i)
+          {
+            uint32_t column = rightToLeft ? w - 1 - i : i;
+            setPixel(buffer, width, dstX + column, dstY + row, getPixel(buffer, width, srcX + column, srcY + row));
+          }
+        }
+      }
+
+      /*!
+       * @brief Get a byte with all pixels set to a value.
+       */
+      static uint8_t pattern(Value value)
+      {
+        uint8_t p = value & MASK;
+        for (uint8_t i = Bits; i < 8; i <<= 1)
+        {
+          p |= p << i;
+        }
+        return p;
+      }
+    };
+
+    /*!
+     * @brief A framebuffer with 2, 4 or 8 bits per pixel and a palette of up to 256 colors.
+     *
+     * The pixels are palette indices, e.g. a 160 * 128 framebuffer with 16 colors needs 10 kB instead of
+     * 40 kB in RGB565. Display drivers convert the pixels to RGB565 with toRGB565() while transferring them.
+     * Drawing functions use the palette entry closest to the requested color.
+     */
+    class FramebufferIndexed : public Framebuffer
+    {
+    public:
+      /*!
+       * @brief Create a new framebuffer. The buffer and the palette are allocated on the heap.
+       * @param width The width of the framebuffer.
+       * @param height The height of the framebuffer.
+       * @param bits The bits per pixel, 2, 4 or 8. All palette entries are black.
+       */
+      FramebufferIndexed(uint16_t width, uint16_t height, uint8_t bits);
+
+      /*!
+       * @brief Get the bits per pixel.
+       */
+      uint8_t bitsPerPixel() const { return bits_; }
+
+      /*!
+       * @brief Get the number of palette entries.
+       */
+      uint16_t colors() const { return 1 << bits_; }
+
+      /*!
+       * @brief Set a palette entry.
+       * @param index The palette index.
+       * @param color The color of the entry.
+       * @note Pixels already drawn with this index change their color on the next display update.
+       */
+      void setPalette(uint8_t index, const Color &color);
+
+      /*!
+       * @brief Set the palette entries starting at index 0.
+       * @param palette The colors.
+       * @param count The number of colors, at most colors().
+       */
+      void setPalette(const Color *palette, uint16_t count);
+
+      /*!
+       * @brief Set the byte order of the RGB565 values of toRGB565().
+       * @param swapBytes True if the bytes should be swapped.
+       */
+      void setSwapBytes(bool swapBytes);
+
+      /*!
+       * @brief Get the palette index closest to a color.
+       */
+      uint8_t value(const Color &color) const;
+
+      NativeColor nativeColor(const Color &color) const override { return value(color); }
+
+      /*!
+       * @brief Convert pixels of a row to RGB565.
+       * @param x The X coordinate of the first pixel.
+       * @param y The Y coordinate.
+       * @param count The number of pixels, the pixels must lie inside the framebuffer.
+       * @param dst The RGB565 values, in the byte order set by setSwapBytes().
+       */
+      void toRGB565(uint16_t x, uint16_t y, uint16_t count, uint16_t *dst) const;
+
+      /*!
+       * @brief Clear the framebuffer.
+       * @param color The color to fill the framebuffer with.
+       */
+      void clear(const Color &color = Color(0, 0, 0)) override;
+
+    protected:
+      /*!
+       * @brief Set a pixel in the buffer.
+       * @param x The X coordinate.
+       * @param y The Y coordinate.
+       */
+      void setPixel(uint16_t x, uint16_t y, NativeColor color) override;
+
+      /*!
+       * @brief Fill a horizontal span.
+       */
+      void fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color) override;
+
+      /*!
+       * @brief Fill a rectangle.
+       */
+      void fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color) override;
+
+      /*!
+       * @brief Copy a block of pixels.
+       */
+      void copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height) override;
+
+    private:
+      static uint32_t requiredSize(uint16_t width, uint16_t height, uint8_t bits);
+
+      uint8_t bits_;
+      uint16_t stride_;
+      bool swapBytes_;
+      uint16_t *lut_;
+      mutable Color lastColor_;
+      mutable int16_t lastIndex_;
+    };
+  }
+}
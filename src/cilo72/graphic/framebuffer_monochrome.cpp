@@ -3,39 +3,213 @@
   SPDX-License-Identifier: MIT-0
 */
 
+#include <assert.h>
 #include "cilo72/graphic/framebuffer_monochrome.h"
 
 namespace cilo72
 {
   namespace graphic
   {
-      FramebufferMonochrome::FramebufferMonochrome(uint8_t width, uint8_t height)
-          : Framebuffer(width, height, width * height / 8)
+      FramebufferMonochrome::FramebufferMonochrome(uint16_t width, uint16_t height)
+          : FramebufferMonochrome(width, height, new uint8_t[PixelFormatMonochrome::bufferSize(width, height)])
       {
       }
 
+      FramebufferMonochrome::FramebufferMonochrome(uint16_t width, uint16_t height, uint8_t *buffer)
+          : Framebuffer(width, height, buffer, PixelFormatMonochrome::bufferSize(width, height)), dither_(Dither::None), errors_(nullptr), errorRow_(UINT32_MAX), ownsErrors_(false)
+      {
+        assert(pages() <= MAX_PAGES);
+        clearDirty();
+      }
+
+      FramebufferMonochrome::~FramebufferMonochrome()
+      {
+        if (ownsErrors_)
+        {
+          delete[] errors_;
+        }
+      }
+
       void FramebufferMonochrome::clear(const Color &color)
       {
-        if (color == Color::white)
+        PixelFormatMonochrome::fillRect(buffer_, width_, 0, 0, width_, height_, value(color));
+        markDirty(Rect(0, 0, width_, height_));
+      }
+
+      void FramebufferMonochrome::setDither(Dither dither)
+      {
+        dither_ = dither;
+        if (dither == Dither::ErrorDiffusion)
         {
-          memset(buffer_, 0xFF, bufferSize_);
+          if (errors_ == nullptr)
+          {
+            errors_ = new int16_t[width_];
+            ownsErrors_ = true;
+          }
+          memset(errors_, 0, width_ * sizeof(int16_t));
         }
-        else
+        errorRow_ = UINT32_MAX;
+      }
+
+      void FramebufferMonochrome::setErrorRow(int16_t *errors)
+      {
+        if (ownsErrors_)
         {
-          memset(buffer_, 0x00, bufferSize_);
+          delete[] errors_;
+          ownsErrors_ = false;
         }
+        errors_ = errors;
+        setDither(dither_);
       }
 
-      void FramebufferMonochrome::drawPixel(uint8_t x, uint8_t y, const Color &color)
+      void FramebufferMonochrome::markDirty(const Rect &rect)
       {
-        if (color == Color::white)
+        Rect r = rect.intersected(Rect(0, 0, width_, height_));
+        if (r.isEmpty())
         {
-          buffer_[x + width_ * (y >> 3)] |= 0x1 << (y & 0x07);
+          return;
         }
-        else
+
+        Framebuffer::markDirty(r);
+
+        for (int32_t page = r.y() >> 3; page <= ((r.bottom() - 1) >> 3); ++page)
         {
-          buffer_[x + width_ * (y >> 3)] &= ~(0x1 << (y & 0x07));
+          if (r.x() < pageDirtyBegin_[page])
+          {
+            pageDirtyBegin_[page] = r.x();
+          }
+          if (r.right() > pageDirtyEnd_[page])
+          {
+            pageDirtyEnd_[page] = r.right();
+          }
         }
       }
+
+      void FramebufferMonochrome::clearDirty()
+      {
+        Framebuffer::clearDirty();
+        for (uint8_t page = 0; page < MAX_PAGES; ++page)
+        {
+          pageDirtyBegin_[page] = UINT16_MAX;
+          pageDirtyEnd_[page] = 0;
+        }
+      }
+
+      void FramebufferMonochrome::setPixel(uint16_t x, uint16_t y, NativeColor color)
+      {
+        PixelFormatMonochrome::setPixel(buffer_, width_, x, y, color);
+      }
+
+      void FramebufferMonochrome::fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color)
+      {
+        PixelFormatMonochrome::fillSpan(buffer_, width_, x, y, width, color);
+      }
+
+      void FramebufferMonochrome::fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color)
+      {
+        PixelFormatMonochrome::fillRect(buffer_, width_, x, y, width, height, color);
+      }
+
+      void FramebufferMonochrome::copySpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *rgb565)
+      {
+        uint8_t *dst = buffer_ + x + width_ * (y >> 3);
+        uint8_t mask = 0x1 << (y & 0x07);
+        if (dither_ == Dither::None)
+        {
+          Framebuffer::copySpan(x, y, width, rgb565);
+          return;
+        }
+
+        if (dither_ == Dither::Ordered)
+        {
+          // the gray level of each pixel against the threshold of its position, without a span per pixel
+          const uint8_t *thresholds = PixelFormatMonochrome::BAYER[y & 7];
+          for (uint32_t i = 0; i < width; ++i)
+          {
+            uint32_t level = (PixelFormatMonochrome::luma(Color::fromRGB565(rgb565[2 * i] << 8 | rgb565[2 * i + 1])) * (PixelFormatMonochrome::LEVELS + 1)) >> 8;
+            dst[i] = level > thresholds[(x + i) & 7] ? dst[i] | mask : dst[i] & ~mask;
+          }
+          return;
+        }
+
+        // the errors of the previous row only apply to the row below it
+        if (y != errorRow_ && y != errorRow_ + 1)
+        {
+          memset(errors_, 0, width_ * sizeof(int16_t));
+        }
+        errorRow_ = y;
+
+        // Floyd-Steinberg with a single row of errors: the error of a pixel goes 7/16 to the right, 3/16 below
+        // left, 5/16 below and 1/16 below right. Below left is already converted and holds the next row, the
+        // share below right is kept until that column is converted.
+        int16_t *errors = errors_ + x;
+        int32_t right = 0;
+        int32_t belowRight = 0;
+        for (uint32_t i = 0; i < width; ++i)
+        {
+          int32_t level = PixelFormatMonochrome::luma(Color::fromRGB565(rgb565[2 * i] << 8 | rgb565[2 * i + 1]));
+          level += (errors[i] + right) >> 4;
+
+          int32_t error;
+          if (level >= 128)
+          {
+            dst[i] |= mask;
+            error = level - 255;
+          }
+          else
+          {
+            dst[i] &= ~mask;
+            error = level;
+          }
+
+          right = 7 * error;
+          if (i > 0)
+          {
+            errors[i - 1] += 3 * error;
+          }
+          errors[i] = 5 * error + belowRight;
+          belowRight = error;
+        }
+      }
+
+      void FramebufferMonochrome::transposedPage(uint8_t page, uint16_t begin, uint16_t end, uint8_t *bytes) const
+      {
+        assert((width_ & 7) == 0 && page < (width_ >> 3) && end <= height_);
+
+        for (uint16_t first = begin & ~7; first < end; first += 8)
+        {
+          // the 8 bytes of the columns 8 * page.. in the page of the rows first.., bit k of byte b is pixel (b, k)
+          const uint8_t *src = buffer_ + (first >> 3) * width_ + page * 8;
+          uint32_t lo = src[0] | src[1] << 8 | src[2] << 16 | src[3] << 24;
+          uint32_t hi = src[4] | src[5] << 8 | src[6] << 16 | src[7] << 24;
+
+          // swap the 1x1, 2x2 and 4x4 sub blocks across the diagonal
+          uint32_t t = (lo ^ (lo >> 7)) & 0x00AA00AA;
+          lo ^= t ^ (t << 7);
+          t = (hi ^ (hi >> 7)) & 0x00AA00AA;
+          hi ^= t ^ (t << 7);
+          t = (lo ^ (lo >> 14)) & 0x0000CCCC;
+          lo ^= t ^ (t << 14);
+          t = (hi ^ (hi >> 14)) & 0x0000CCCC;
+          hi ^= t ^ (t << 14);
+          t = (hi & 0xF0F0F0F0) | ((lo >> 4) & 0x0F0F0F0F);
+          lo = ((hi << 4) & 0xF0F0F0F0) | (lo & 0x0F0F0F0F);
+          hi = t;
+
+          uint8_t block[8] = {(uint8_t)lo, (uint8_t)(lo >> 8), (uint8_t)(lo >> 16), (uint8_t)(lo >> 24),
+                              (uint8_t)hi, (uint8_t)(hi >> 8), (uint8_t)(hi >> 16), (uint8_t)(hi >> 24)};
+          uint16_t from = first < begin ? begin : first;
+          uint16_t to = first + 8 < end ? first + 8 : end;
+          for (uint16_t c = from; c < to; ++c)
+          {
+            *bytes++ = block[c - first];
+          }
+        }
+      }
+
+      void FramebufferMonochrome::copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height)
+      {
+        PixelFormatMonochrome::copyRect(buffer_, width_, srcX, srcY, dstX, dstY, width, height);
+      }
   }
 }
@@ -13,19 +13,269 @@ namespace cilo72
 {
   namespace graphic
   {
+    class FramebufferMonochrome;
+
+    /*!
+     * @brief Pixel operations for the monochrome page layout (8 vertical pixels per byte, one page per 8 rows).
+     *
+     * Used by FramebufferMonochrome and BasicFramebuffer. The stride is the width of the framebuffer in pixels.
+     */
+    struct PixelFormatMonochrome
+    {
+      using Framebuffer = FramebufferMonochrome;
+
+      /*!
+       * @brief 0 for black, 1 for white or DITHERED | level for a gray level, see ditheredValue().
+       */
+      using Value = uint32_t;
+
+      static constexpr Value DITHERED = 0x100; //< Flag of a gray level drawn with the ordered dither pattern.
+      static constexpr uint8_t LEVELS = 64;    //< Number of gray levels between black and white.
+
+      /*!
+       * @brief The 8x8 Bayer matrix, the threshold of the pixel in column x and row y is BAYER[y & 7][x & 7].
+       */
+      static constexpr uint8_t BAYER[8][8] = {
+          {0, 32, 8, 40, 2, 34, 10, 42},
+          {48, 16, 56, 24, 50, 18, 58, 26},
+          {12, 44, 4, 36, 14, 46, 6, 38},
+          {60, 28, 52, 20, 62, 30, 54, 22},
+          {3, 35, 11, 43, 1, 33, 9, 41},
+          {51, 19, 59, 27, 49, 17, 57, 25},
+          {15, 47, 7, 39, 13, 45, 5, 37},
+          {63, 31, 55, 23, 61, 29, 53, 21}};
+
+      static constexpr size_t bufferSize(uint32_t width, uint32_t height) { return width * height / 8; }
+
+      static Value value(const Color &color) { return color == Color::white; }
+
+      /*!
+       * @brief Get the brightness of a color, 0 - 255.
+       */
+      static constexpr uint8_t luma(const Color &color) { return (77 * color.r() + 150 * color.g() + 29 * color.b()) >> 8; }
+
+      /*!
+       * @brief Get the value of a color for ordered dithering.
+       *
+       * Black and white stay solid, other colors are mapped to one of LEVELS gray levels. A pixel of a gray level
+       * is white if the level is greater than the Bayer threshold of its position.
+       */
+      static Value ditheredValue(const Color &color)
+      {
+        uint32_t level = (luma(color) * (LEVELS + 1)) >> 8;
+        return level == 0 ? 0 : (level >= LEVELS ? 1 : DITHERED | level);
+      }
+
+      /*!
+       * @brief Get the 8 pixels of a value in column x of a page, bit 0 is the top row.
+       */
+      static uint8_t pattern(Value value, uint32_t x)
+      {
+        if (not(value & DITHERED))
+        {
+          return value ? 0xFF : 0x00;
+        }
+
+        uint8_t level = value & 0xFF;
+        uint8_t bits = 0;
+        for (uint8_t row = 0; row < 8; ++row)
+        {
+          bits |= (level > BAYER[row][x & 7]) << row;
+        }
+        return bits;
+      }
+
+      static void setPixel(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, Value value)
+      {
+        bool white = value & DITHERED ? (value & 0xFF) > BAYER[y & 7][x & 7] : value != 0;
+        if (white)
+        {
+          buffer[x + stride * (y >> 3)] |= 0x1 << (y & 0x07);
+        }
+        else
+        {
+          buffer[x + stride * (y >> 3)] &= ~(0x1 << (y & 0x07));
+        }
+      }
+
+      static void fillSpan(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, Value value)
+      {
+        uint8_t *dst = buffer + x + stride * (y >> 3);
+        uint8_t mask = 0x1 << (y & 0x07);
+        if (value & DITHERED)
+        {
+          // the pattern of the row, rotated so bit 0 is the first pixel
+          const uint8_t *thresholds = BAYER[y & 7];
+          uint8_t level = value & 0xFF;
+          uint8_t row = 0;
+          for (uint8_t i = 0; i < 8; ++i)
+          {
+            row |= (level > thresholds[(x + i) & 7]) << i;
+          }
+          for (uint32_t i = 0; i < width; ++i)
+          {
+            dst[i] = row & (1 << (i & 7)) ? dst[i] | mask : dst[i] & ~mask;
+          }
+        }
+        else if (value)
+        {
+          for (uint32_t i = 0; i < width; ++i)
+          {
+            dst[i] |= mask;
+          }
+        }
+        else
+        {
+          mask = ~mask;
+          for (uint32_t i = 0; i < width; ++i)
+          {
+            dst[i] &= mask;
+          }
+        }
+      }
+
+      static void fillRect(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, uint32_t height, Value value)
+      {
+        // the Bayer matrix repeats every 8 rows, so each column has the same pattern in every page
+        uint8_t patterns[8];
+        if (value & DITHERED)
+        {
+          for (uint8_t i = 0; i < 8; ++i)
+          {
+            patterns[i] = pattern(value, x + i);
+          }
+        }
+
+        uint32_t bottom = y + height;
+        while (y < bottom)
+        {
+          uint32_t page = y >> 3;
+          uint32_t pageBottom = (page + 1) << 3;
+          uint32_t end = bottom < pageBottom ? bottom : pageBottom;
+          uint8_t mask = (0xFF << (y & 0x07)) & (0xFF >> (pageBottom - end));
+          uint8_t *dst = buffer + x + stride * page;
+
+          if (value & DITHERED)
+          {
+            for (uint32_t i = 0; i < width; ++i)
+            {
+              dst[i] = (dst[i] & ~mask) | (patterns[i & 7] & mask);
+            }
+          }
+          else if (mask == 0xFF)
+          {
+            memset(dst, value ? 0xFF : 0x00, width);
+          }
+          else if (value)
+          {
+            for (uint32_t i = 0; i < width; ++i)
+            {
+              dst[i] |= mask;
+            }
+          }
+          else
+          {
+            mask = ~mask;
+            for (uint32_t i = 0; i < width; ++i)
+            {
+              dst[i] &= mask;
+            }
+          }
+          y = end;
+        }
+      }
+
+      /*!
+       * @brief Copy a block of pixels, the blocks may overlap.
+       *
+       * Each destination byte is assembled from the two source bytes of the column it overlaps with a shift,
+       * so vertical moves work at bit level across page boundaries. The columns and pages are processed in
+       * the direction of the move, so no source byte is overwritten before it is read.
+       */
+      static void copyRect(uint8_t *buffer, uint32_t stride, uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height)
+      {
+        uint32_t endPage = (dstY + height + 7) >> 3;
+        uint32_t firstPage = dstY >> 3;
+        int32_t dy = (int32_t)dstY - (int32_t)srcY;
+        uint32_t srcPages = (srcY + height + 7) >> 3;
+
+        for (uint32_t i = 0; i < width; ++i)
+        {
+          uint32_t column = dstX > srcX ? width - 1 - i : i;
+          const uint8_t *src = buffer + srcX + column;
+          uint8_t *dst = buffer + dstX + column;
+
+          for (uint32_t n = 0; n < endPage - firstPage; ++n)
+          {
+            uint32_t page = dy > 0 ? endPage - 1 - n : firstPage + n;
+
+            // rows of this page inside the destination
+            uint32_t top = page << 3;
+            uint32_t begin = dstY > top ? dstY - top : 0;
+            uint32_t end = dstY + height < top + 8 ? dstY + height - top : 8;
+            uint8_t mask = (0xFF << begin) & (0xFF >> (8 - end));
+
+            // source row of bit 0, the source page below bit 0 and the shift within it
+            int32_t row = (int32_t)top - dy;
+            int32_t srcPage = row >= 0 ? row >> 3 : -((7 - row) >> 3);
+            uint8_t shift = row - srcPage * 8;
+
+            uint16_t window = 0;
+            if (srcPage >= 0)
+            {
+              window = src[stride * srcPage];
+            }
+            if (shift != 0 && srcPage + 1 < (int32_t)srcPages)
+            {
+              window |= src[stride * (srcPage + 1)] << 8;
+            }
+
+            uint8_t *d = dst + stride * page;
+            *d = (*d & ~mask) | ((window >> shift) & mask);
+          }
+        }
+      }
+    };
+
     /*!
      * @brief A framebuffer for monochrome displays.
-     * @note All non-white colors are treated as black.
+     * @note Without dithering all non-white colors are treated as black, see setDither().
      */
     class FramebufferMonochrome : public Framebuffer
     {
     public:
       /*!
-       * @brief Create a new framebuffer.
+       * @brief The conversion of colors to black and white pixels.
+       */
+      enum class Dither
+      {
+        None,          //< Only white is white.
+        Ordered,       //< Colors are drawn with an 8x8 Bayer pattern of their brightness.
+        ErrorDiffusion //< Like Ordered, but color bitmaps are converted with Floyd-Steinberg error diffusion.
+      };
+
+      /*!
+       * @brief Create a new framebuffer. The buffer is allocated on the heap.
+       * @param width The width of the framebuffer.
+       * @param height The height of the framebuffer.
+       */
+      FramebufferMonochrome(uint16_t width, uint16_t height);
+
+      /*!
+       * @brief Create a new framebuffer on an existing buffer.
        * @param width The width of the framebuffer.
        * @param height The height of the framebuffer.
+       * @param buffer The buffer, at least PixelFormatMonochrome::bufferSize(width, height) bytes.
        */
-      FramebufferMonochrome(uint8_t width, uint8_t height);
+      FramebufferMonochrome(uint16_t width, uint16_t height, uint8_t *buffer);
+
+      /*!
+       * @brief Destroy the framebuffer and the error row allocated by setDither().
+       */
+      ~FramebufferMonochrome();
+
+      FramebufferMonochrome(const FramebufferMonochrome &) = delete;
+      FramebufferMonochrome &operator=(const FramebufferMonochrome &) = delete;
 
       /*!
        * @brief Clear the framebuffer.
@@ -34,11 +284,128 @@ namespace cilo72
       void clear(const Color &color = Color(0, 0, 0)) override;
 
       /*!
-       * @brief Draw a pixel on the display.
+       * @brief Add a rectangle to the dirty region.
+       * @param rect The modified rectangle. It is clipped to the framebuffer.
+       *
+       * In addition to the bounding rectangle, the modified column range of every page is tracked.
+       */
+      void markDirty(const Rect &rect) override;
+
+      /*!
+       * @brief Reset the dirty region and the dirty column ranges of all pages.
+       */
+      void clearDirty() override;
+
+      /*!
+       * @brief Get the number of pages (8 rows each) of the framebuffer.
+       */
+      uint16_t pages() const { return height_ >> 3; }
+
+      /*!
+       * @brief Check if a page was modified since the last call of clearDirty().
+       * @param page The page index.
+       */
+      bool isPageDirty(uint8_t page) const { return pageDirtyEnd_[page] > pageDirtyBegin_[page]; }
+
+      /*!
+       * @brief Get the first modified column of a page.
+       * @param page The page index.
+       */
+      uint16_t pageDirtyBegin(uint8_t page) const { return pageDirtyBegin_[page]; }
+
+      /*!
+       * @brief Get the column after the last modified column of a page.
+       * @param page The page index.
+       */
+      uint16_t pageDirtyEnd(uint8_t page) const { return pageDirtyEnd_[page]; }
+
+      /*!
+       * @brief Get a part of a page of the transposed framebuffer, for displays rotated by 90 degrees.
+       *
+       * Page p of the transposed framebuffer holds the columns 8p..8p+7 and its column c is the row c. Each group
+       * of 8 columns is one 8x8 bit block, transposed with shifts and masks from 8 adjacent bytes of the buffer,
+       * so the framebuffer is read sequentially instead of bit by bit.
+       *
+       * @param page The page of the transposed framebuffer, 0 - width / 8 - 1.
+       * @param begin The first column, i.e. the first row of the framebuffer.
+       * @param end The column after the last column.
+       * @param bytes The end - begin bytes of the columns.
+       * @note The width has to be a multiple of 8.
+       */
+      void transposedPage(uint8_t page, uint16_t begin, uint16_t end, uint8_t *bytes) const;
+
+      /*!
+       * @brief Set the conversion of colors.
+       *
+       * The dithering applies per primitive, a filled square of a gray color is drawn with the Bayer pattern
+       * of its brightness. The pattern is aligned to the framebuffer, so adjacent primitives of the same color
+       * join seamlessly. Color bitmaps are dithered per pixel.
+       *
+       * Error diffusion keeps the error of one row, width * 2 bytes. Without a row from setErrorRow(), it is
+       * allocated on the heap with the first use and freed with the framebuffer.
+       * The error is carried over as long as the rows of the bitmaps are drawn top down without gaps.
+       *
+       * @param dither The conversion.
+       */
+      void setDither(Dither dither);
+
+      /*!
+       * @brief Use a row provided by the caller for the error of error diffusion instead of the heap.
+       * @param errors The row, at least width() entries. It is not owned and has to outlive the framebuffer.
+       */
+      void setErrorRow(int16_t *errors);
+
+      /*!
+       * @brief Get the conversion of colors.
+       */
+      Dither dither() const { return dither_; }
+
+      /*!
+       * @brief Get the native value of a color.
+       */
+      PixelFormatMonochrome::Value value(const Color &color) const
+      {
+        return dither_ == Dither::None ? PixelFormatMonochrome::value(color) : PixelFormatMonochrome::ditheredValue(color);
+      }
+
+      NativeColor nativeColor(const Color &color) const override { return value(color); }
+
+    protected:
+      /*!
+       * @brief Set a pixel in the buffer.
        * @param x The X coordinate.
        * @param y The Y coordinate.
        */
-      void drawPixel(uint8_t x, uint8_t y, const Color &color) override;
+      void setPixel(uint16_t x, uint16_t y, NativeColor color) override;
+
+      /*!
+       * @brief Fill a horizontal span.
+       */
+      void fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color) override;
+
+      /*!
+       * @brief Fill a rectangle.
+       */
+      void fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color) override;
+
+      /*!
+       * @brief Copy RGB565 pixels, dithered with error diffusion if enabled.
+       */
+      void copySpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *rgb565) override;
+
+      /*!
+       * @brief Copy a block of pixels.
+       */
+      void copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height) override;
+
+      static constexpr uint8_t MAX_PAGES = 16; //< Maximum number of pages, i.e. 128 rows.
+
+      uint16_t pageDirtyBegin_[MAX_PAGES];
+      uint16_t pageDirtyEnd_[MAX_PAGES];
+      Dither dither_;
+      int16_t *errors_;   //< The error per column in 1/16, left of the converted pixel for the next row, right of it for the current row.
+      uint32_t errorRow_; //< The last row converted with error diffusion.
+      bool ownsErrors_;   //< True if errors_ was allocated by setDither().
     };
   }
 }
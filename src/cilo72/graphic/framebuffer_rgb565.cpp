@@ -9,26 +9,56 @@ namespace cilo72
 {
   namespace graphic
   {
-      FramebufferRGB565::FramebufferRGB565(uint8_t width, uint8_t height)
-          : Framebuffer(width, height, width * height * 2)
+      FramebufferRGB565::FramebufferRGB565(uint16_t width, uint16_t height)
+          : FramebufferRGB565(width, height, new uint8_t[PixelFormatRGB565::bufferSize(width, height)])
+      {
+      }
+
+      FramebufferRGB565::FramebufferRGB565(uint16_t width, uint16_t height, uint8_t *buffer)
+          : Framebuffer(width, height, buffer, PixelFormatRGB565::bufferSize(width, height))
           , swapBytes_(false)
       {
       }
 
       void FramebufferRGB565::clear(const Color &color)
       {
-        uint16_t color565 = color.toRGB565(color, swapBytes_);
-        uint16_t *buffer = (uint16_t *)buffer_;
-        for(uint32_t i = 0; i < height_ * width_; i++)
-        {
-          buffer[i] = color565;
-        }
+        PixelFormatRGB565::fill((uint16_t *)buffer_, value(color), height_ * width_);
+        markDirty(Rect(0, 0, width_, height_));
+      }
+
+      void FramebufferRGB565::setPixel(uint16_t x, uint16_t y, NativeColor color)
+      {
+        PixelFormatRGB565::setPixel(buffer_, width_, x, y, color);
+      }
+
+      void FramebufferRGB565::fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color)
+      {
+        PixelFormatRGB565::fillSpan(buffer_, width_, x, y, width, color);
+      }
+
+      void FramebufferRGB565::fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color)
+      {
+        PixelFormatRGB565::fillRect(buffer_, width_, x, y, width, height, color);
+      }
+
+      void FramebufferRGB565::copySpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *rgb565)
+      {
+        PixelFormatRGB565::copySpan(buffer_, width_, x, y, width, rgb565, swapBytes_);
+      }
+
+      void FramebufferRGB565::blendSpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *alpha, NativeColor color)
+      {
+        PixelFormatRGB565::blendSpan(buffer_, width_, x, y, width, alpha, color, swapBytes_);
+      }
+
+      void FramebufferRGB565::blendRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t alpha, NativeColor color)
+      {
+        PixelFormatRGB565::blendRect(buffer_, width_, x, y, width, height, alpha, color, swapBytes_);
       }
 
-      void FramebufferRGB565::drawPixel(uint8_t x, uint8_t y, const Color &color)
+      void FramebufferRGB565::copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height)
       {
-        uint16_t *buffer = (uint16_t *)buffer_;
-        buffer[y * width_ + x] = color.toRGB565(color, swapBytes_);
+        PixelFormatRGB565::copyRect(buffer_, width_, srcX, srcY, dstX, dstY, width, height);
       }
   }
-}
+}
\ No newline at end of file
@@ -13,6 +13,228 @@ namespace cilo72
 {
   namespace graphic
   {
+    class FramebufferRGB565;
+
+    /*!
+     * @brief Pixel operations for the RGB565 layout (one 16 bit word per pixel, row by row).
+     *
+     * Used by FramebufferRGB565 and BasicFramebuffer. The stride is the width of the framebuffer in pixels.
+     */
+    struct PixelFormatRGB565
+    {
+      using Framebuffer = FramebufferRGB565;
+      using Value = uint16_t; //< RGB565 value, byte swapped if required by the display.
+
+      static constexpr size_t bufferSize(uint32_t width, uint32_t height) { return width * height * 2; }
+
+      static Value value(const Color &color, bool swapBytes) { return color.toRGB565(color, swapBytes); }
+
+      static void setPixel(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, Value value)
+      {
+        ((uint16_t *)buffer)[y * stride + x] = value;
+      }
+
+      /*!
+       * @brief Fill count pixels with the same value, two pixels per 32 bit store.
+       */
+      static void fill(uint16_t *dst, Value value, uint32_t count)
+      {
+        if (count > 0 && ((uintptr_t)dst & 0x02))
+        {
+          *dst++ = value;
+          --count;
+        }
+
+        uint32_t value2 = ((uint32_t)value << 16) | value;
+        uint32_t *dst2 = (uint32_t *)dst;
+        for (uint32_t i = count >> 1; i > 0; --i)
+        {
+          *dst2++ = value2;
+        }
+
+        if (count & 1)
+        {
+          *(uint16_t *)dst2 = value;
+        }
+      }
+
+      static void fillSpan(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, Value value)
+      {
+        fill((uint16_t *)buffer + y * stride + x, value, width);
+      }
+
+      static void fillRect(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, uint32_t height, Value value)
+      {
+        uint16_t *row = (uint16_t *)buffer + y * stride + x;
+        if (width == stride)
+        {
+          fill(row, value, width * height);
+          return;
+        }
+
+        for (uint32_t j = 0; j < height; ++j, row += stride)
+        {
+          fill(row, value, width);
+        }
+      }
+
+      /*!
+       * @brief Copy pixels stored high byte first into a span.
+       * @param swapBytes True if the buffer stores the pixels high byte first as well, then it is a plain copy.
+       */
+      static void copySpan(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, const uint8_t *src, bool swapBytes)
+      {
+        uint8_t *dst = buffer + (y * stride + x) * 2;
+        if (swapBytes)
+        {
+          memcpy(dst, src, width * 2);
+          return;
+        }
+
+        for (uint32_t i = 0; i < width; ++i, dst += 2, src += 2)
+        {
+          dst[0] = src[1];
+          dst[1] = src[0];
+        }
+      }
+
+      /*!
+       * @brief Swap the bytes of a pixel.
+       */
+      static uint16_t swap(uint16_t value) { return (value >> 8) | (value << 8); }
+
+      /*!
+       * @brief Swap the bytes of both pixels of a 32 bit word.
+       */
+      static uint32_t swap2(uint32_t value) { return ((value & 0x00FF00FF) << 8) | ((value >> 8) & 0x00FF00FF); }
+
+      /*!
+       * @brief Blend a color over a pixel.
+       *
+       * The channels are spread over a 32 bit word, green in the upper half, red and blue in the lower half, with
+       * 5 spare bits above each channel. One multiplication per operand weights all three channels, the alpha is
+       * reduced to 5 bits, so the division is a shift. No hardware divide is needed.
+       *
+       * @param dst The background pixel.
+       * @param src The foreground pixel.
+       * @param alpha The opacity of the foreground, 0 - 255.
+       * @return The blended pixel. All values are in native (not swapped) byte order.
+       */
+      static uint16_t blend(uint16_t dst, uint16_t src, uint8_t alpha)
+      {
+        uint32_t a = (alpha + 4) >> 3;
+        uint32_t d = (dst | (uint32_t)dst << 16) & 0x07E0F81F;
+        uint32_t s = (src | (uint32_t)src << 16) & 0x07E0F81F;
+        d = (d * (32 - a) + s * a) >> 5 & 0x07E0F81F;
+        return d | d >> 16;
+      }
+
+      /*!
+       * @brief Blend two pixels of a 32 bit word with the same alpha.
+       *
+       * The word is split into two words with every other channel (blue and red of the first pixel with green
+       * of the second, and the remaining channels shifted down by 5 bits), each with 5 spare bits above every
+       * channel. Both pixels are blended with four multiplications.
+       *
+       * @param dst2 Two background pixels.
+       * @param src2 Two foreground pixels.
+       * @param alpha The opacity of the foreground, 0 - 255.
+       * @return The blended pixels. All values are in native (not swapped) byte order.
+       */
+      static uint32_t blend2(uint32_t dst2, uint32_t src2, uint8_t alpha)
+      {
+        uint32_t a = (alpha + 4) >> 3;
+        uint32_t even = ((dst2 & 0x07E0F81F) * (32 - a) + (src2 & 0x07E0F81F) * a) >> 5 & 0x07E0F81F;
+        uint32_t odd = (((dst2 >> 5) & 0x07C0F83F) * (32 - a) + ((src2 >> 5) & 0x07C0F83F) * a) & 0xF81F07E0;
+        return even | odd;
+      }
+
+      /*!
+       * @brief Blend a color over a span with a coverage per pixel, e.g. a row of an antialiased glyph.
+       * @param alpha The coverage of each pixel, 0 - 255.
+       * @param swapBytes True if the buffer and the value are byte swapped.
+       */
+      static void blendSpan(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, const uint8_t *alpha, Value value, bool swapBytes)
+      {
+        uint16_t *dst = (uint16_t *)buffer + y * stride + x;
+        uint16_t src = swapBytes ? swap(value) : value;
+        for (uint32_t i = 0; i < width; ++i)
+        {
+          if (alpha[i] == 0xFF)
+          {
+            dst[i] = value;
+          }
+          else if (alpha[i] != 0)
+          {
+            dst[i] = swapBytes ? swap(blend(swap(dst[i]), src, alpha[i])) : blend(dst[i], src, alpha[i]);
+          }
+        }
+      }
+
+      /*!
+       * @brief Blend a color with the same alpha over a rectangle, two pixels per 32 bit load and store.
+       * @param alpha The opacity of the color, 0 - 255.
+       * @param swapBytes True if the buffer and the value are byte swapped.
+       */
+      static void blendRect(uint8_t *buffer, uint32_t stride, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t alpha, Value value, bool swapBytes)
+      {
+        uint16_t src = swapBytes ? swap(value) : value;
+        uint32_t src2 = (uint32_t)src << 16 | src;
+        uint16_t *row = (uint16_t *)buffer + y * stride + x;
+        for (uint32_t j = 0; j < height; ++j, row += stride)
+        {
+          uint16_t *dst = row;
+          uint32_t count = width;
+          if (count > 0 && ((uintptr_t)dst & 0x02))
+          {
+            *dst = swapBytes ? swap(blend(swap(*dst), src, alpha)) : blend(*dst, src, alpha);
+            ++dst;
+            --count;
+          }
+
+          uint32_t *dst2 = (uint32_t *)dst;
+          for (uint32_t i = count >> 1; i > 0; --i, ++dst2)
+          {
+            *dst2 = swapBytes ? swap2(blend2(swap2(*dst2), src2, alpha)) : blend2(*dst2, src2, alpha);
+          }
+
+          if (count & 1)
+          {
+            dst = (uint16_t *)dst2;
+            *dst = swapBytes ? swap(blend(swap(*dst), src, alpha)) : blend(*dst, src, alpha);
+          }
+        }
+      }
+
+      /*!
+       * @brief Copy a block of pixels with one memmove per row, the blocks may overlap.
+       */
+      static void copyRect(uint8_t *buffer, uint32_t stride, uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height)
+      {
+        uint16_t *src = (uint16_t *)buffer + srcY * stride + srcX;
+        uint16_t *dst = (uint16_t *)buffer + dstY * stride + dstX;
+        if (width == stride)
+        {
+          memmove(dst, src, width * height * 2);
+          return;
+        }
+
+        int32_t step = stride;
+        if (dstY > srcY)
+        {
+          // bottom up, the source rows below are not overwritten before they are copied
+          src += (height - 1) * stride;
+          dst += (height - 1) * stride;
+          step = -step;
+        }
+
+        for (uint32_t j = 0; j < height; ++j, src += step, dst += step)
+        {
+          memmove(dst, src, width * 2);
+        }
+      }
+    };
+
     /*!
      * @brief A framebuffer for RGB565 displays.
      */
@@ -20,11 +242,19 @@ namespace cilo72
     {
     public:
       /*!
-       * @brief Create a new framebuffer.
+       * @brief Create a new framebuffer. The buffer is allocated on the heap.
        * @param width The width of the framebuffer.
        * @param height The height of the framebuffer.
        */
-      FramebufferRGB565(uint8_t width, uint8_t height);
+      FramebufferRGB565(uint16_t width, uint16_t height);
+
+      /*!
+       * @brief Create a new framebuffer on an existing buffer.
+       * @param width The width of the framebuffer.
+       * @param height The height of the framebuffer.
+       * @param buffer The buffer, at least PixelFormatRGB565::bufferSize(width, height) bytes, 16 bit aligned.
+       */
+      FramebufferRGB565(uint16_t width, uint16_t height, uint8_t *buffer);
 
       /*!
        * @brief Set the framebuffer to swap bytes.
@@ -32,20 +262,57 @@ namespace cilo72
        */
       void setSwapBytes(bool swapBytes) { swapBytes_ = swapBytes; }
 
+      /*!
+       * @brief Get the native value of a color.
+       */
+      PixelFormatRGB565::Value value(const Color &color) const { return PixelFormatRGB565::value(color, swapBytes_); }
+
+      NativeColor nativeColor(const Color &color) const override { return value(color); }
+
       /*!
        * @brief Clear the framebuffer.
        * @param color The color to fill the framebuffer with.
        */
       void clear(const Color &color = Color(0, 0, 0)) override;
 
+    protected:
       /*!
-       * @brief Draw a pixel on the display.
+       * @brief Set a pixel in the buffer.
        * @param x The X coordinate.
        * @param y The Y coordinate.
        */
-      void drawPixel(uint8_t x, uint8_t y, const Color &color) override;
+      void setPixel(uint16_t x, uint16_t y, NativeColor color) override;
+
+      /*!
+       * @brief Fill a horizontal span.
+       */
+      void fillSpan(uint32_t x, uint32_t y, uint32_t width, NativeColor color) override;
+
+      /*!
+       * @brief Fill a rectangle.
+       */
+      void fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, NativeColor color) override;
+
+      /*!
+       * @brief Copy RGB565 pixels into a span.
+       */
+      void copySpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *rgb565) override;
+
+      /*!
+       * @brief Blend a color over a span with a coverage per pixel.
+       */
+      void blendSpan(uint32_t x, uint32_t y, uint32_t width, const uint8_t *alpha, NativeColor color) override;
+
+      /*!
+       * @brief Blend a color over a rectangle.
+       */
+      void blendRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t alpha, NativeColor color) override;
+
+      /*!
+       * @brief Copy a block of pixels.
+       */
+      void copyBlock(uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY, uint32_t width, uint32_t height) override;
 
-    protected:
       bool swapBytes_;
     };
   }
@@ -0,0 +1,130 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <assert.h>
+#include "cilo72/graphic/glyph_cache.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    GlyphCache::GlyphCache(Glyph *glyphs, size_t count)
+        : glyphs_(glyphs), count_(count), time_(0), hits_(0), misses_(0)
+    {
+      assert(count_ > 0);
+      clear();
+    }
+
+    void GlyphCache::clear()
+    {
+      for (size_t i = 0; i < count_; ++i)
+      {
+        glyphs_[i].font = nullptr;
+        glyphs_[i].lastUse = 0;
+      }
+    }
+
+    const GlyphCache::Glyph *GlyphCache::lookup(const cilo72::fonts::Font &font, char c, uint32_t scale)
+    {
+      const uint8_t *data = font.data();
+      Glyph *oldest = &glyphs_[0];
+
+      ++time_;
+      for (size_t i = 0; i < count_; ++i)
+      {
+        Glyph &glyph = glyphs_[i];
+        if (glyph.font == data && glyph.c == c && glyph.scale == scale)
+        {
+          ++hits_;
+          glyph.lastUse = time_;
+          return &glyph;
+        }
+        if (glyph.lastUse < oldest->lastUse)
+        {
+          oldest = &glyph;
+        }
+      }
+
+      ++misses_;
+      if (not rasterize(font, c, scale, *oldest))
+      {
+        return nullptr;
+      }
+
+      oldest->font = data;
+      oldest->c = c;
+      oldest->scale = scale;
+      oldest->lastUse = time_;
+      return oldest;
+    }
+
+    bool GlyphCache::rasterize(const cilo72::fonts::Font &font, char c, uint32_t scale, Glyph &glyph)
+    {
+      uint32_t parts_per_line = (font.height() >> 3) + ((font.height() & 7) > 0);
+      if (font.width() > 32 || parts_per_line > 4 || font.width() * scale > 255 || font.height() * scale > 255)
+      {
+        return false;
+      }
+
+      // one bit per column for every row of the glyph
+      uint32_t rows[32] = {0};
+      for (uint8_t w = 0; w < font.width(); ++w)
+      {
+        uint32_t pp = (c - font.firstAscciiChar()) * font.width() * parts_per_line + w * parts_per_line;
+        for (uint32_t lp = 0; lp < parts_per_line; ++lp)
+        {
+          uint8_t line = font.data()[pp++];
+          for (uint8_t j = 0; j < 8; ++j, line >>= 1)
+          {
+            if (line & 1)
+            {
+              rows[(lp << 3) + j] |= 1u << w;
+            }
+          }
+        }
+      }
+
+      // cover the set bits with rectangles: take a run of a row and extend it downwards
+      uint8_t count = 0;
+      for (uint8_t row = 0; row < font.height(); ++row)
+      {
+        while (rows[row])
+        {
+          if (count == MAX_RECTS)
+          {
+            glyph.font = nullptr;
+            glyph.lastUse = 0;
+            return false;
+          }
+
+          uint8_t x = __builtin_ctz(rows[row]);
+          uint8_t width = 0;
+          uint32_t mask = 0;
+          while (x + width < 32 && (rows[row] & (1u << (x + width))))
+          {
+            mask |= 1u << (x + width);
+            ++width;
+          }
+
+          uint8_t height = 1;
+          while (row + height < font.height() && (rows[row + height] & mask) == mask)
+          {
+            ++height;
+          }
+
+          for (uint8_t i = 0; i < height; ++i)
+          {
+            rows[row + i] &= ~mask;
+          }
+
+          glyph.rects[count++] = {(uint8_t)(x * scale), (uint8_t)(row * scale), (uint8_t)(width * scale), (uint8_t)(height * scale)};
+        }
+      }
+
+      glyph.count = count;
+      return true;
+    }
+  }
+}
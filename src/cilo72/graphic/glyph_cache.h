@@ -0,0 +1,115 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cilo72/fonts/font.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A least recently used cache of rasterized glyphs.
+     *
+     * A glyph is decomposed once into a few filled rectangles, already multiplied by the scale.
+     * Drawing a cached glyph is then one fillRect() per rectangle instead of one per set bit.
+     * The rectangles do not depend on the pixel format or the color, so one cache can be shared by
+     * several framebuffers.
+     *
+     * @see Framebuffer::setGlyphCache()
+     */
+    class GlyphCache
+    {
+    public:
+      static constexpr uint8_t MAX_RECTS = 16; //< Glyphs needing more rectangles are not cached.
+
+      /*!
+       * @brief A filled rectangle of a glyph, relative to the top-left corner of the character cell.
+       */
+      struct GlyphRect
+      {
+        uint8_t x;
+        uint8_t y;
+        uint8_t width;
+        uint8_t height;
+      };
+
+      /*!
+       * @brief A cache entry.
+       */
+      struct Glyph
+      {
+        const uint8_t *font; //< The font data, identifies the font.
+        uint32_t lastUse;
+        char c;
+        uint8_t scale;
+        uint8_t count; //< Number of valid rectangles.
+        GlyphRect rects[MAX_RECTS];
+      };
+
+      /*!
+       * @brief Create a glyph cache on existing memory.
+       * @param glyphs The cache entries.
+       * @param count The number of entries.
+       */
+      GlyphCache(Glyph *glyphs, size_t count);
+
+      /*!
+       * @brief Get a glyph, rasterize it on a cache miss.
+       * @param font The font.
+       * @param c The character.
+       * @param scale The scaling factor.
+       * @return The glyph or nullptr if the glyph can not be cached.
+       */
+      const Glyph *lookup(const cilo72::fonts::Font &font, char c, uint32_t scale);
+
+      /*!
+       * @brief Remove all glyphs from the cache.
+       */
+      void clear();
+
+      /*!
+       * @brief Get the number of cache hits.
+       */
+      uint32_t hits() const { return hits_; }
+
+      /*!
+       * @brief Get the number of cache misses.
+       */
+      uint32_t misses() const { return misses_; }
+
+    private:
+      Glyph *glyphs_;
+      size_t count_;
+      uint32_t time_;
+      uint32_t hits_;
+      uint32_t misses_;
+
+      static bool rasterize(const cilo72::fonts::Font &font, char c, uint32_t scale, Glyph &glyph);
+    };
+
+    /*!
+     * @brief A glyph cache with a compile time memory budget.
+     * @tparam Bytes The memory budget in bytes.
+     */
+    template <size_t Bytes>
+    class StaticGlyphCache : public GlyphCache
+    {
+    public:
+      static constexpr size_t GLYPHS = Bytes / sizeof(Glyph); //< Number of cached glyphs.
+      static_assert(GLYPHS > 0, "Memory budget too small for one glyph");
+
+      StaticGlyphCache() : GlyphCache(glyphs_, GLYPHS)
+      {
+      }
+
+    private:
+      Glyph glyphs_[GLYPHS];
+    };
+  }
+}
@@ -0,0 +1,152 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <assert.h>
+#include "cilo72/graphic/numeric_field.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    namespace
+    {
+      constexpr uint32_t POWERS_OF_TEN[] = {
+          1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+      constexpr uint8_t MAX_DIGITS = sizeof(POWERS_OF_TEN) / sizeof(POWERS_OF_TEN[0]);
+    }
+
+    NumericField::NumericField(int32_t x, int32_t y, uint8_t cells, const cilo72::fonts::Font &font, uint32_t scale, uint8_t decimals)
+        : font_(font), x_(x), y_(y), value_(0), scale_(scale), cells_(cells), decimals_(decimals), valid_(false)
+        , color_(Color::white), background_(0, 0, 0)
+    {
+      assert(cells <= MAX_CELLS && decimals < MAX_DIGITS);
+      format();
+    }
+
+    void NumericField::setValue(int32_t value)
+    {
+      value_ = value;
+      format();
+    }
+
+    void NumericField::setColors(const Color &color, const Color &background)
+    {
+      color_ = color;
+      background_ = background;
+      valid_ = false;
+    }
+
+    Rect NumericField::bounds() const
+    {
+      int32_t advance = (font_.width() + font_.spacingPerChar()) * scale_;
+      return Rect(x_, y_, cells_ * advance, font_.height() * scale_);
+    }
+
+    Rect NumericField::damage() const
+    {
+      if (not valid_)
+      {
+        return bounds();
+      }
+
+      int32_t first = -1;
+      int32_t last = -1;
+      for (uint8_t i = 0; i < cells_; ++i)
+      {
+        if (text_[i] != shown_[i])
+        {
+          first = first < 0 ? i : first;
+          last = i;
+        }
+      }
+      if (first < 0)
+      {
+        return Rect();
+      }
+
+      int32_t advance = (font_.width() + font_.spacingPerChar()) * scale_;
+      return Rect(x_ + first * advance, y_, (last - first + 1) * advance, font_.height() * scale_);
+    }
+
+    uint8_t NumericField::draw(Framebuffer &fb)
+    {
+      int32_t advance = (font_.width() + font_.spacingPerChar()) * scale_;
+      uint32_t height = font_.height() * scale_;
+      uint8_t redrawn = 0;
+      for (uint8_t i = 0; i < cells_; ++i)
+      {
+        if (valid_ && text_[i] == shown_[i])
+        {
+          continue;
+        }
+
+        int32_t x = x_ + i * advance;
+        fb.drawSquare(x, y_, advance, height, background_);
+        if (text_[i] != ' ')
+        {
+          fb.drawChar(x, y_, scale_, text_[i], color_, font_);
+        }
+        shown_[i] = text_[i];
+        ++redrawn;
+      }
+
+      valid_ = true;
+      return redrawn;
+    }
+
+    void NumericField::format()
+    {
+      // digits by subtracting powers of ten, the M0+ has no divide instruction
+      char digits[MAX_DIGITS];
+      uint8_t count = 0;
+      uint32_t magnitude = value_ < 0 ? 0u - (uint32_t)value_ : (uint32_t)value_;
+      for (uint8_t k = 0; k < MAX_DIGITS; ++k)
+      {
+        uint8_t digit = 0;
+        while (magnitude >= POWERS_OF_TEN[k])
+        {
+          magnitude -= POWERS_OF_TEN[k];
+          ++digit;
+        }
+
+        // no leading zeros, but at least one digit before the decimal point
+        if (digit != 0 || count > 0 || MAX_DIGITS - k <= decimals_ + 1)
+        {
+          digits[count++] = '0' + digit;
+        }
+      }
+
+      uint8_t length = count + (decimals_ > 0) + (value_ < 0);
+      if (length > cells_)
+      {
+        for (uint8_t i = 0; i < cells_; ++i)
+        {
+          text_[i] = '#';
+        }
+        text_[cells_] = '\0';
+        return;
+      }
+
+      uint8_t i = 0;
+      for (; i < cells_ - length; ++i)
+      {
+        text_[i] = ' ';
+      }
+      if (value_ < 0)
+      {
+        text_[i++] = '-';
+      }
+      for (uint8_t d = 0; d < count; ++d)
+      {
+        if (decimals_ > 0 && d == count - decimals_)
+        {
+          text_[i++] = '.';
+        }
+        text_[i++] = digits[d];
+      }
+      text_[i] = '\0';
+    }
+  }
+}
@@ -0,0 +1,103 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "framebuffer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A right aligned number that redraws only the characters that changed.
+     *
+     * The value is formatted without printf into a fixed number of character cells, e.g. " -12.50" for
+     * -1250 with 2 decimals in 7 cells. draw() compares the new characters with the ones on the screen and
+     * redraws only the cells that differ, so only these cells are marked dirty. A 6 digit value changing in
+     * the last digit costs one glyph.
+     *
+     * Values that do not fit are shown as '#' in all cells.
+     */
+    class NumericField
+    {
+    public:
+      static constexpr uint8_t MAX_CELLS = 12; //< Maximum number of character cells.
+
+      /*!
+       * @brief Create a numeric field.
+       * @param x The X coordinate of the top-left corner relative to the viewport.
+       * @param y The Y coordinate of the top-left corner relative to the viewport.
+       * @param cells The number of characters including sign and decimal point, at most MAX_CELLS.
+       * @param font The fixed width font, it has to outlive the field.
+       * @param scale The character scaling factor.
+       * @param decimals The number of digits after the decimal point, the value is a fixed point number.
+       */
+      NumericField(int32_t x, int32_t y, uint8_t cells, const cilo72::fonts::Font &font, uint32_t scale = 1, uint8_t decimals = 0);
+
+      /*!
+       * @brief Set the value.
+       * @param value The value, scaled by 10 ^ decimals.
+       */
+      void setValue(int32_t value);
+
+      /*!
+       * @brief Get the value.
+       */
+      int32_t value() const { return value_; }
+
+      /*!
+       * @brief Set the colors. All cells are redrawn by the next draw().
+       * @param color The color of the characters.
+       * @param background The color of the cells.
+       */
+      void setColors(const Color &color, const Color &background);
+
+      /*!
+       * @brief Redraw all cells with the next draw(), e.g. after the screen was cleared.
+       */
+      void invalidate() { valid_ = false; }
+
+      /*!
+       * @brief Draw the cells that changed since the last call.
+       * @param fb The framebuffer.
+       * @return The number of redrawn cells.
+       */
+      uint8_t draw(Framebuffer &fb);
+
+      /*!
+       * @brief Get the formatted value.
+       */
+      const char *text() const { return text_; }
+
+      /*!
+       * @brief Get the rectangle of all cells relative to the viewport.
+       */
+      Rect bounds() const;
+
+      /*!
+       * @brief Get the rectangle of the cells the next draw() redraws, empty if nothing changed.
+       */
+      Rect damage() const;
+
+    private:
+      void format();
+
+      const cilo72::fonts::Font &font_;
+      int32_t x_;
+      int32_t y_;
+      int32_t value_;
+      uint32_t scale_;
+      uint8_t cells_;
+      uint8_t decimals_;
+      bool valid_;
+      Color color_;
+      Color background_;
+      char text_[MAX_CELLS + 1];
+      char shown_[MAX_CELLS + 1];
+    };
+  }
+}
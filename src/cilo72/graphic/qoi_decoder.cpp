@@ -0,0 +1,151 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <string.h>
+#include "cilo72/graphic/qoi_decoder.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    namespace
+    {
+      constexpr uint8_t OP_INDEX = 0x00;
+      constexpr uint8_t OP_DIFF = 0x40;
+      constexpr uint8_t OP_LUMA = 0x80;
+      constexpr uint8_t OP_RUN = 0xC0;
+      constexpr uint8_t OP_RGB = 0xFE;
+      constexpr uint8_t OP_RGBA = 0xFF;
+
+      uint32_t bigEndian32(const uint8_t *p)
+      {
+        return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+      }
+    }
+
+    QoiDecoder::QoiDecoder(const uint8_t *data, size_t size)
+        : data_(data), end_(data + size), p_(data), remaining_(0), width_(0), height_(0), run_(0)
+    {
+      if (size < HEADER_SIZE || memcmp(data, "qoif", 4) != 0)
+      {
+        return;
+      }
+
+      uint32_t width = bigEndian32(data + 4);
+      uint32_t height = bigEndian32(data + 8);
+      if (width <= UINT16_MAX && height <= UINT16_MAX)
+      {
+        width_ = width;
+        height_ = height;
+      }
+      rewind();
+    }
+
+    void QoiDecoder::rewind()
+    {
+      p_ = data_ + HEADER_SIZE;
+      remaining_ = (uint32_t)width_ * height_;
+      run_ = 0;
+      pixel_ = {0, 0, 0, 255};
+      memset(index_, 0, sizeof(index_));
+    }
+
+    size_t QoiDecoder::read(uint8_t *rgb565, size_t count)
+    {
+      size_t n = 0;
+      while (n < count && remaining_ > 0)
+      {
+        if (run_ == 0 && not next())
+        {
+          remaining_ = 0;
+          break;
+        }
+
+        // the pixel of an operation is converted once, runs are written without decoding
+        uint16_t value = (pixel_.r >> 3) << 11 | (pixel_.g >> 2) << 5 | pixel_.b >> 3;
+        uint8_t high = value >> 8;
+        uint8_t low = value;
+        size_t k = run_ < count - n ? run_ : count - n;
+        k = k < remaining_ ? k : remaining_;
+        for (size_t i = 0; i < k; ++i)
+        {
+          *rgb565++ = high;
+          *rgb565++ = low;
+        }
+        run_ -= k;
+        remaining_ -= k;
+        n += k;
+      }
+      return n;
+    }
+
+    /*
+     * Decode the next operation into pixel_ and the number of pixels of this color into run_.
+     */
+    bool QoiDecoder::next()
+    {
+      if (p_ >= end_)
+      {
+        return false;
+      }
+
+      uint8_t op = *p_++;
+      uint8_t run = 1;
+      if (op == OP_RGB || op == OP_RGBA)
+      {
+        size_t length = op == OP_RGB ? 3 : 4;
+        if ((size_t)(end_ - p_) < length)
+        {
+          return false;
+        }
+        pixel_.r = p_[0];
+        pixel_.g = p_[1];
+        pixel_.b = p_[2];
+        if (op == OP_RGBA)
+        {
+          pixel_.a = p_[3];
+        }
+        p_ += length;
+      }
+      else
+      {
+        switch (op & 0xC0)
+        {
+        case OP_INDEX:
+          pixel_ = index_[op];
+          break;
+
+        case OP_DIFF:
+          pixel_.r += ((op >> 4) & 0x03) - 2;
+          pixel_.g += ((op >> 2) & 0x03) - 2;
+          pixel_.b += (op & 0x03) - 2;
+          break;
+
+        case OP_LUMA:
+        {
+          if (p_ >= end_)
+          {
+            return false;
+          }
+          uint8_t rb = *p_++;
+          int8_t dg = (op & 0x3F) - 32;
+          pixel_.r += dg - 8 + (rb >> 4);
+          pixel_.g += dg;
+          pixel_.b += dg - 8 + (rb & 0x0F);
+          break;
+        }
+
+        case OP_RUN:
+          run = (op & 0x3F) + 1;
+          break;
+        }
+      }
+
+      index_[(pixel_.r * 3 + pixel_.g * 5 + pixel_.b * 7 + pixel_.a * 11) & 63] = pixel_;
+      run_ = run;
+      return true;
+    }
+  }
+}
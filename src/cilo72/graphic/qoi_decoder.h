@@ -0,0 +1,84 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief Decodes a QOI image (https://qoiformat.org) in chunks of pixels.
+     *
+     * QOI is lossless and decodes with a few operations per pixel and a table of 64 colors, so a photo or a logo
+     * can be streamed from flash to a display window without holding the image in RAM, see ST7735S::drawImage().
+     * The pixels are converted to RGB565, high byte first like the RGB565 bitmaps. The alpha channel is ignored.
+     *
+     * tools/bitmap_converter.py -f qoi creates the image data.
+     */
+    class QoiDecoder
+    {
+    public:
+      static constexpr size_t HEADER_SIZE = 14; //< Size of the QOI header.
+
+      /*!
+       * @brief Create a decoder.
+       * @param data The QOI file, not copied.
+       * @param size The size of the file in bytes.
+       */
+      QoiDecoder(const uint8_t *data, size_t size);
+
+      /*!
+       * @brief Check if the data starts with a valid QOI header.
+       */
+      bool valid() const { return width_ > 0 && height_ > 0; }
+
+      uint16_t width() const { return width_; }
+      uint16_t height() const { return height_; }
+
+      /*!
+       * @brief Get the number of pixels not decoded yet.
+       */
+      uint32_t remaining() const { return remaining_; }
+
+      /*!
+       * @brief Decode the next pixels.
+       * @param rgb565 The pixels, 2 bytes each, high byte first.
+       * @param count The maximum number of pixels.
+       * @return The number of decoded pixels, less than count at the end of the image or of truncated data.
+       */
+      size_t read(uint8_t *rgb565, size_t count);
+
+      /*!
+       * @brief Start again with the first pixel.
+       */
+      void rewind();
+
+    private:
+      struct Pixel
+      {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+        uint8_t a;
+      };
+
+      bool next();
+
+      const uint8_t *data_;
+      const uint8_t *end_;
+      const uint8_t *p_;
+      uint32_t remaining_;
+      uint16_t width_;
+      uint16_t height_;
+      uint8_t run_;
+      Pixel pixel_;
+      Pixel index_[64];
+    };
+  }
+}
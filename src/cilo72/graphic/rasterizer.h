@@ -0,0 +1,1043 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "framebuffer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief Drawing algorithms shared by Framebuffer and BasicFramebuffer.
+     *
+     * The algorithms are templates on the framebuffer type. Instantiated with Framebuffer, the pixel
+     * operations are virtual calls. Instantiated with a (final) BasicFramebuffer, they are resolved at
+     * compile time and inlined into the loops.
+     *
+     * The public functions take coordinates relative to the current viewport. The origin offset, the clip
+     * rectangle and the color conversion are applied once per primitive, the fill operations only see visible
+     * spans and rectangles with a native color.
+     */
+    class Rasterizer
+    {
+    public:
+      template <class Target>
+      static void drawSquare(Target &fb, int32_t x, int32_t y, uint32_t width, uint32_t height, const Color &color)
+      {
+        Rect r = Rect(x + fb.originX_, y + fb.originY_, width, height).intersected(fb.clip_);
+        if (r.isEmpty())
+        {
+          return;
+        }
+
+        fb.markDirty(r);
+        fb.fillRect(r.x(), r.y(), r.width(), r.height(), fb.nativeColor(color));
+      }
+
+      template <class Target>
+      static void drawLine(Target &fb, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const Color &color)
+      {
+        // saturated to the int16_t range of Rect before and after the offset, so the deltas of drawLineRuns()
+        // stay below 2^16 and its error term fits into 32 bits
+        x1 = saturate(saturate(x1) + fb.originX_);
+        y1 = saturate(saturate(y1) + fb.originY_);
+        x2 = saturate(saturate(x2) + fb.originX_);
+        y2 = saturate(saturate(y2) + fb.originY_);
+
+        const Rect &clip = fb.clip_;
+        if (Framebuffer::outCode(x1, y1, clip) & Framebuffer::outCode(x2, y2, clip))
+        {
+          return;
+        }
+
+        int32_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+        int32_t dy = y2 > y1 ? y2 - y1 : y1 - y2;
+        if (dx >= dy)
+        {
+          if (x1 > x2)
+          {
+            Framebuffer::swap(&x1, &x2);
+            Framebuffer::swap(&y1, &y2);
+          }
+          drawLineRuns(fb, false, x1, y1, x2, y2, clip.x(), clip.right() - 1, clip.y(), clip.bottom() - 1, fb.nativeColor(color));
+        }
+        else
+        {
+          if (y1 > y2)
+          {
+            Framebuffer::swap(&x1, &x2);
+            Framebuffer::swap(&y1, &y2);
+          }
+          drawLineRuns(fb, true, y1, x1, y2, x2, clip.y(), clip.bottom() - 1, clip.x(), clip.right() - 1, fb.nativeColor(color));
+        }
+      }
+
+      template <class Target>
+      static void drawChar(Target &fb, int32_t x, int32_t y, uint32_t scale, char c, const Color &color, const cilo72::fonts::Font &font)
+      {
+        drawGlyph(fb, x + fb.originX_, y + fb.originY_, scale, c, fb.nativeColor(color), font);
+      }
+
+      template <class Target>
+      static void drawString(Target &fb, int32_t x, int32_t y, uint32_t scale, const char *s, const Color &color, const cilo72::fonts::Font &font, Framebuffer::Position position)
+      {
+        x += fb.originX_;
+        y += fb.originY_;
+
+        int32_t length = strlen(s);
+        int32_t advance = (font.width() + font.spacingPerChar()) * scale;
+        int32_t width = length > 0 ? length * advance - (int32_t)(font.spacingPerChar() * scale) : 0;
+        int32_t height = font.height() * scale;
+
+        align(position, width, height, x, y);
+
+        drawGlyphs(fb, x, y, scale, s, length, fb.nativeColor(color), font);
+      }
+
+      template <class Target>
+      static void drawText(Target &fb, int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, const Color &color, const cilo72::fonts::Font &font)
+      {
+        drawGlyphs(fb, x + fb.originX_, y + fb.originY_, scale, s, length, fb.nativeColor(color), font);
+      }
+
+      template <class Target>
+      static void drawChar(Target &fb, int32_t x, int32_t y, uint32_t scale, char c, const Color &color, const cilo72::fonts::ProportionalFont &font)
+      {
+        const cilo72::fonts::ProportionalFont::Glyph *glyph = font.glyph(c);
+        if (glyph)
+        {
+          drawGlyph(fb, x + fb.originX_ + glyph->left * (int32_t)scale, y + fb.originY_, scale, *glyph, fb.nativeColor(color), font);
+        }
+      }
+
+      template <class Target>
+      static void drawString(Target &fb, int32_t x, int32_t y, uint32_t scale, const char *s, const Color &color, const cilo72::fonts::ProportionalFont &font, Framebuffer::Position position)
+      {
+        x += fb.originX_;
+        y += fb.originY_;
+
+        // the width is only needed to align the text to the right or the center
+        bool left = position == Framebuffer::TopLeft || position == Framebuffer::BottomLeft || position == Framebuffer::CenterLeft;
+        int32_t width = left ? 0 : font.textWidth(s) * scale;
+        int32_t height = font.height() * scale;
+
+        align(position, width, height, x, y);
+
+        drawGlyphs(fb, x, y, scale, s, SIZE_MAX, fb.nativeColor(color), font);
+      }
+
+      template <class Target>
+      static void drawText(Target &fb, int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, const Color &color, const cilo72::fonts::ProportionalFont &font)
+      {
+        drawGlyphs(fb, x + fb.originX_, y + fb.originY_, scale, s, length, fb.nativeColor(color), font);
+      }
+
+      template <class Target>
+      static void drawString(Target &fb, int32_t x, int32_t y, const char *s, const cilo72::fonts::AlphaFont &font, const Color &color, Framebuffer::Position position)
+      {
+        x += fb.originX_;
+        y += fb.originY_;
+
+        int32_t length = strlen(s);
+        int32_t advance = font.width() + font.spacingPerChar();
+        int32_t width = length > 0 ? length * advance - font.spacingPerChar() : 0;
+        align(position, width, font.height(), x, y);
+
+        if (y >= fb.clip_.bottom() || y + font.height() <= fb.clip_.y())
+        {
+          return;
+        }
+
+        Framebuffer::NativeColor native = fb.nativeColor(color);
+        for (int32_t x_n = x; *s && x_n < fb.clip_.right(); x_n += advance)
+        {
+          const uint8_t *glyph = font.glyph(*(s++));
+          Rect visible = Rect(x_n, y, font.width(), font.height()).intersected(fb.clip_);
+          if (glyph == nullptr || visible.isEmpty())
+          {
+            continue;
+          }
+
+          fb.markDirty(visible);
+          glyph += (visible.y() - y) * font.width() + (visible.x() - x_n);
+          for (int32_t row = visible.y(); row < visible.bottom(); ++row, glyph += font.width())
+          {
+            fb.blendSpan(visible.x(), row, visible.width(), glyph, native);
+          }
+        }
+      }
+
+      template <class Target>
+      static void blendSquare(Target &fb, int32_t x, int32_t y, uint32_t width, uint32_t height, const Color &color, uint8_t alpha)
+      {
+        Rect visible = Rect(x + fb.originX_, y + fb.originY_, width, height).intersected(fb.clip_);
+        if (visible.isEmpty() || alpha == 0)
+        {
+          return;
+        }
+
+        fb.markDirty(visible);
+        fb.blendRect(visible.x(), visible.y(), visible.width(), visible.height(), alpha, fb.nativeColor(color));
+      }
+
+      template <class Target>
+      static void drawEllipse(Target &fb, int32_t cx, int32_t cy, uint32_t rx, uint32_t ry, const Color &color)
+      {
+        int32_t a = rx < MAX_RADIUS ? rx : MAX_RADIUS;
+        int32_t b = ry < MAX_RADIUS ? ry : MAX_RADIUS;
+        cx += fb.originX_;
+        cy += fb.originY_;
+        fillRounded(fb, cx - a, cy - b, cx + a, cy + b, a, b, fb.nativeColor(color));
+      }
+
+      template <class Target>
+      static void drawRoundedSquare(Target &fb, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t radius, const Color &color)
+      {
+        if (width == 0 || height == 0)
+        {
+          return;
+        }
+
+        int32_t w = width < UINT16_MAX ? width : UINT16_MAX;
+        int32_t h = height < UINT16_MAX ? height : UINT16_MAX;
+        int32_t r = radius < MAX_RADIUS ? radius : MAX_RADIUS;
+        r = r < (w - 1) / 2 ? r : (w - 1) / 2;
+        r = r < (h - 1) / 2 ? r : (h - 1) / 2;
+        x += fb.originX_;
+        y += fb.originY_;
+        fillRounded(fb, x, y, x + w - 1, y + h - 1, r, r, fb.nativeColor(color));
+      }
+
+      /*
+       * The crossings of each edge with the rows are stepped with integer quotient and remainder, one division
+       * per edge. A row is filled between pairs of crossings (even-odd rule), so concave polygons work as well.
+       */
+      template <class Target>
+      static void drawPolygon(Target &fb, const Point *points, size_t count, const Color &color)
+      {
+        struct Edge
+        {
+          int32_t top;
+          int32_t bottom;
+          int32_t x;
+          int32_t remainder;
+          int32_t step;
+          int32_t stepRemainder;
+          int32_t height;
+        };
+
+        if (count < 3)
+        {
+          return;
+        }
+        count = count < Framebuffer::MAX_POLYGON_VERTICES ? count : Framebuffer::MAX_POLYGON_VERTICES;
+
+        int32_t left = INT32_MAX;
+        int32_t top = INT32_MAX;
+        int32_t right = INT32_MIN;
+        int32_t bottom = INT32_MIN;
+        for (size_t i = 0; i < count; ++i)
+        {
+          left = points[i].x < left ? points[i].x : left;
+          right = points[i].x > right ? points[i].x : right;
+          top = points[i].y < top ? points[i].y : top;
+          bottom = points[i].y > bottom ? points[i].y : bottom;
+        }
+
+        Rect visible = Rect(left + fb.originX_, top + fb.originY_, right - left, bottom - top).intersected(fb.clip_);
+        if (visible.isEmpty())
+        {
+          return;
+        }
+        fb.markDirty(visible);
+
+        // the edges are oriented top down, horizontal edges never cross a row
+        Edge edges[Framebuffer::MAX_POLYGON_VERTICES];
+        size_t n = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+          const Point &p = points[i];
+          const Point &q = points[i + 1 < count ? i + 1 : 0];
+          if (p.y == q.y)
+          {
+            continue;
+          }
+
+          int32_t x0 = (p.y < q.y ? p.x : q.x) + fb.originX_;
+          int32_t y0 = (p.y < q.y ? p.y : q.y) + fb.originY_;
+          int32_t x1 = (p.y < q.y ? q.x : p.x) + fb.originX_;
+          int32_t y1 = (p.y < q.y ? q.y : p.y) + fb.originY_;
+          int32_t dx = x1 - x0;
+          int32_t dy = y1 - y0;
+
+          // the crossing with the first visible row, x = x0 + (y - y0) * dx / dy as quotient and remainder
+          int32_t y = y0 > visible.y() ? y0 : visible.y();
+          int64_t numerator = (int64_t)x0 * dy + (int64_t)(y - y0) * dx;
+          int32_t x = -ceilDiv(-numerator, dy);
+          int32_t step = -ceilDiv(-dx, dy);
+          edges[n++] = {y0, y1, x, (int32_t)(numerator - (int64_t)x * dy), step, dx - step * dy, dy};
+        }
+
+        Framebuffer::NativeColor native = fb.nativeColor(color);
+        int32_t crossings[Framebuffer::MAX_POLYGON_VERTICES];
+        for (int32_t y = visible.y(); y < visible.bottom(); ++y)
+        {
+          size_t m = 0;
+          for (size_t i = 0; i < n; ++i)
+          {
+            Edge &e = edges[i];
+            if (y < e.top || y >= e.bottom)
+            {
+              continue;
+            }
+
+            // the first pixel right of or on the edge, insertion sort by x
+            int32_t x = e.x + (e.remainder > 0);
+            size_t j = m++;
+            for (; j > 0 && crossings[j - 1] > x; --j)
+            {
+              crossings[j] = crossings[j - 1];
+            }
+            crossings[j] = x;
+
+            e.x += e.step;
+            e.remainder += e.stepRemainder;
+            if (e.remainder >= e.height)
+            {
+              e.remainder -= e.height;
+              ++e.x;
+            }
+          }
+
+          for (size_t j = 0; j + 1 < m; j += 2)
+          {
+            fillSpan(fb, crossings[j], crossings[j + 1] - 1, y, native);
+          }
+        }
+      }
+
+      template <class Target>
+      static void drawArc(Target &fb, int32_t cx, int32_t cy, uint32_t radius, uint32_t thickness, int32_t startAngle, int32_t endAngle, const Color &color)
+      {
+        int32_t sweep = endAngle - startAngle;
+        if (sweep <= 0 || thickness == 0)
+        {
+          return;
+        }
+
+        int32_t outer = radius < MAX_RADIUS ? radius : MAX_RADIUS;
+        int32_t inner = thickness < (uint32_t)outer ? outer - thickness : -1;
+        cx += fb.originX_;
+        cy += fb.originY_;
+        if (Rect(cx - outer, cy - outer, 2 * outer + 1, 2 * outer + 1).intersected(fb.clip_).isEmpty())
+        {
+          return;
+        }
+
+        // the direction vectors of the start and the end, the angle grows clockwise on the screen
+        int32_t start = startAngle % 360;
+        start = start < 0 ? start + 360 : start;
+        int32_t end = start + sweep % 360;
+        end = end >= 360 ? end - 360 : end;
+        Arc arc;
+        arc.full = sweep >= 360;
+        arc.convex = sweep <= 180;
+        arc.startX = sine(start + 90);
+        arc.startY = sine(start);
+        arc.endX = sine(end + 90);
+        arc.endY = sine(end);
+        arc.left = INT32_MAX;
+        arc.right = INT32_MIN;
+        arc.top = INT32_MAX;
+        arc.bottom = INT32_MIN;
+
+        Framebuffer::NativeColor native = fb.nativeColor(color);
+        EllipseRows outerRows(outer, outer);
+        EllipseRows innerRows(inner, inner);
+        for (int32_t k = outer; k >= 0; --k)
+        {
+          int32_t ho = outerRows.next();
+          int32_t hi = k <= inner ? innerRows.next() : -1;
+          fillArcRow(fb, arc, cx, cy - k, -k, ho, hi, native);
+          if (k > 0)
+          {
+            fillArcRow(fb, arc, cx, cy + k, k, ho, hi, native);
+          }
+        }
+
+        if (arc.left <= arc.right)
+        {
+          fb.markDirty(Rect(arc.left, arc.top, arc.right - arc.left + 1, arc.bottom - arc.top + 1));
+        }
+      }
+
+      template <class Target>
+      static void blit(Target &fb, int32_t x, int32_t y, const Bitmap &bitmap, const Color &color)
+      {
+        x += fb.originX_;
+        y += fb.originY_;
+
+        Rect visible = Rect(x, y, bitmap.width(), bitmap.height()).intersected(fb.clip_);
+        if (visible.isEmpty())
+        {
+          return;
+        }
+
+        fb.markDirty(visible);
+
+        // visible part in bitmap coordinates
+        int32_t left = visible.x() - x;
+        int32_t right = visible.right() - x;
+        int32_t top = visible.y() - y;
+        int32_t bottom = visible.bottom() - y;
+
+        switch (bitmap.format())
+        {
+        case Bitmap::Format::Monochrome:
+        {
+          Framebuffer::NativeColor native = fb.nativeColor(color);
+          for (int32_t row = top; row < bottom; ++row)
+          {
+            const uint8_t *bits = bitmap.data() + row * bitmap.stride();
+            int32_t i = left;
+            while (i < right)
+            {
+              for (; i < right && not(bits[i >> 3] & (0x80 >> (i & 7))); ++i)
+              {
+              }
+              int32_t start = i;
+              for (; i < right && (bits[i >> 3] & (0x80 >> (i & 7))); ++i)
+              {
+              }
+              if (i > start)
+              {
+                fb.fillSpan(x + start, y + row, i - start, native);
+              }
+            }
+          }
+          break;
+        }
+
+        case Bitmap::Format::RGB565:
+          for (int32_t row = top; row < bottom; ++row)
+          {
+            copyPixels(fb, x + left, y + row, bitmap.data() + (row * bitmap.width() + left) * 2, right - left, bitmap.key());
+          }
+          break;
+
+        case Bitmap::Format::RLE565:
+        {
+          const uint8_t *p = bitmap.data();
+          int32_t col = 0;
+          int32_t row = 0;
+          while (row < bottom)
+          {
+            uint8_t n = *p++;
+            bool repeat = n & 0x80;
+            int32_t count = (n & 0x7F) + 1;
+            uint16_t value = p[0] << 8 | p[1];
+            while (count > 0 && row < bottom)
+            {
+              int32_t len = count < bitmap.width() - col ? count : bitmap.width() - col;
+              int32_t a = col > left ? col : left;
+              int32_t b = col + len < right ? col + len : right;
+              if (row >= top && a < b)
+              {
+                if (not repeat)
+                {
+                  copyPixels(fb, x + a, y + row, p + (a - col) * 2, b - a, bitmap.key());
+                }
+                else if (value != bitmap.key())
+                {
+                  fb.fillSpan(x + a, y + row, b - a, fb.nativeColor(Color::fromRGB565(value)));
+                }
+              }
+
+              if (not repeat)
+              {
+                p += len * 2;
+              }
+              count -= len;
+              col += len;
+              if (col == bitmap.width())
+              {
+                col = 0;
+                ++row;
+              }
+            }
+            if (repeat)
+            {
+              p += 2;
+            }
+          }
+          break;
+        }
+        }
+      }
+
+    private:
+      /*
+       * Draw at most length characters of a fixed width font at framebuffer coordinates.
+       */
+      template <class Target>
+      static void drawGlyphs(Target &fb, int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Framebuffer::NativeColor color, const cilo72::fonts::Font &font)
+      {
+        if (y >= fb.clip_.bottom() || y + (int32_t)(font.height() * scale) <= fb.clip_.y())
+        {
+          return;
+        }
+
+        int32_t advance = (font.width() + font.spacingPerChar()) * scale;
+        for (; length > 0 && *s && x < fb.clip_.right(); --length, x += advance)
+        {
+          drawGlyph(fb, x, y, scale, *(s++), color, font);
+        }
+      }
+
+      /*
+       * Draw at most length characters of a proportional font at framebuffer coordinates.
+       */
+      template <class Target>
+      static void drawGlyphs(Target &fb, int32_t x, int32_t y, uint32_t scale, const char *s, size_t length, Framebuffer::NativeColor color, const cilo72::fonts::ProportionalFont &font)
+      {
+        if (y >= fb.clip_.bottom() || y + (int32_t)(font.height() * scale) <= fb.clip_.y())
+        {
+          return;
+        }
+
+        // a glyph with a negative left bearing may reach into the clip rectangle from a pen position right of it
+        for (; length > 0 && *s && x + INT8_MIN * (int32_t)scale < fb.clip_.right(); --length, ++s)
+        {
+          const cilo72::fonts::ProportionalFont::Glyph *glyph = font.glyph(*s);
+          if (glyph)
+          {
+            drawGlyph(fb, x + glyph->left * (int32_t)scale, y, scale, *glyph, color, font);
+            x += glyph->advance * scale;
+          }
+        }
+      }
+
+      /*
+       * Move the position of a text block to its top-left corner.
+       */
+      static void align(Framebuffer::Position position, int32_t width, int32_t height, int32_t &x, int32_t &y)
+      {
+        switch(position)
+        {
+          case Framebuffer::TopLeft:
+            break;
+  
+          case Framebuffer::TopRight:
+            x -= width;
+            break;
+  
+          case Framebuffer::Center:
+            x -= width / 2;
+            y -= height / 2;
+            break;
+  
+          case Framebuffer::BottomLeft:
+            y -= height;
+            break;
+  
+          case Framebuffer::BottomRight:
+            x -= width;
+            y -= height;
+            break;
+  
+          case Framebuffer::CenterRight:
+            x -= width;
+            y -= height / 2;
+            break;
+  
+          case Framebuffer::CenterLeft:
+            y -= height / 2;
+            break;
+        }
+      }
+
+      /*
+       * Draw a character at framebuffer coordinates.
+       */
+      template <class Target>
+      static void drawGlyph(Target &fb, int32_t x, int32_t y, uint32_t scale, char c, Framebuffer::NativeColor color, const cilo72::fonts::Font &font)
+      {
+        if (c < font.firstAscciiChar() || c > font.lastAscciiChar())
+        {
+          return;
+        }
+
+        Rect cell(x, y, font.width() * scale, font.height() * scale);
+        Rect visible = cell.intersected(fb.clip_);
+        if (visible.isEmpty())
+        {
+          return;
+        }
+
+        fb.markDirty(visible);
+        bool clipped = not(visible == cell);
+
+        const GlyphCache::Glyph *glyph = fb.glyphCache_ ? fb.glyphCache_->lookup(font, c, scale) : nullptr;
+        if (glyph)
+        {
+          for (uint8_t i = 0; i < glyph->count; ++i)
+          {
+            const GlyphCache::GlyphRect &r = glyph->rects[i];
+            fillRect(fb, clipped, x + r.x, y + r.y, r.width, r.height, color);
+          }
+          return;
+        }
+
+        uint32_t parts_per_line = (font.height() >> 3) + ((font.height() & 7) > 0);
+        for (uint8_t w = 0; w < font.width(); ++w)
+        { // width
+          uint32_t pp = (c - font.firstAscciiChar()) * font.width() * parts_per_line + w * parts_per_line;
+          for (uint32_t lp = 0; lp < parts_per_line; ++lp)
+          {
+            uint8_t line = font.data()[pp];
+
+            for (int8_t j = 0; j < 8; ++j, line >>= 1)
+            {
+              if (line & 1)
+              {
+                fillRect(fb, clipped, x + w * scale, y + ((lp << 3) + j) * scale, scale, scale, color);
+              }
+            }
+            ++pp;
+          }
+        }
+      }
+
+      /*
+       * Draw a glyph of a proportional font at framebuffer coordinates. The set bits of a column are merged
+       * into vertical runs, each run is one fillRect().
+       */
+      template <class Target>
+      static void drawGlyph(Target &fb, int32_t x, int32_t y, uint32_t scale, const cilo72::fonts::ProportionalFont::Glyph &glyph, Framebuffer::NativeColor color, const cilo72::fonts::ProportionalFont &font)
+      {
+        Rect cell(x, y, glyph.width * scale, font.height() * scale);
+        Rect visible = cell.intersected(fb.clip_);
+        if (visible.isEmpty())
+        {
+          return;
+        }
+
+        fb.markDirty(visible);
+        bool clipped = not(visible == cell);
+
+        cilo72::fonts::ProportionalFont::Reader reader(font, glyph);
+        uint8_t parts = font.bytesPerColumn();
+        for (uint8_t column = 0; column < glyph.width; ++column)
+        {
+          int32_t start = -1;
+          int32_t row = 0;
+          for (uint8_t part = 0; part < parts; ++part)
+          {
+            uint8_t bits = reader.next();
+            for (uint8_t j = 0; j < 8; ++j, ++row, bits >>= 1)
+            {
+              if (bits & 1)
+              {
+                start = start < 0 ? row : start;
+              }
+              else if (start >= 0)
+              {
+                fillRect(fb, clipped, x + column * scale, y + start * scale, scale, (row - start) * scale, color);
+                start = -1;
+              }
+            }
+          }
+
+          if (start >= 0)
+          {
+            fillRect(fb, clipped, x + column * scale, y + start * scale, scale, (row - start) * scale, color);
+          }
+        }
+      }
+
+      static constexpr int32_t MAX_RADIUS = 0x3FFF;
+      static constexpr int32_t UNBOUNDED = 0x3FFFFFFF;
+
+      /*
+       * sin(0) ... sin(90 degrees) scaled by 2^14.
+       */
+      static constexpr int16_t SINE[91] = {
+          0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+          2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+          5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+          8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+          10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+          12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+          14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+          15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+          16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+          16384};
+
+      /*
+       * The sine of an angle in degrees, 0 - 719, scaled by 2^14.
+       */
+      static int32_t sine(int32_t degrees)
+      {
+        degrees = degrees >= 360 ? degrees - 360 : degrees;
+        if (degrees < 180)
+        {
+          return SINE[degrees <= 90 ? degrees : 180 - degrees];
+        }
+        degrees -= 180;
+        return -SINE[degrees <= 90 ? degrees : 180 - degrees];
+      }
+
+      /*
+       * The half widths of the rows of an ellipse with the semi-axes a and b, from the top row to the center row.
+       * The pixel (h, k) relative to the center is inside if 4 h^2 (2b + 1)^2 + 4 k^2 (2a + 1)^2 <= (2a + 1)^2 (2b + 1)^2,
+       * so the ellipse passes through the outer edges of the pixels at (a, 0) and (0, b). The half width only grows
+       * towards the center, each row costs a few additions.
+       */
+      class EllipseRows
+      {
+      public:
+        EllipseRows(int32_t a, int32_t b)
+        {
+          int64_t a2 = (int64_t)(2 * a + 1) * (2 * a + 1);
+          int64_t b2 = (int64_t)(2 * b + 1) * (2 * b + 1);
+          room_ = a2 * b2 - 4 * (int64_t)b * b * a2;
+          roomStep_ = a2 * (8 * (int64_t)b - 4);
+          roomStepStep_ = 8 * a2;
+          next_ = 4 * b2;
+          nextStep_ = 12 * b2;
+          nextStepStep_ = 8 * b2;
+          h_ = 0;
+        }
+
+        /*
+         * Get the half width of the current row and move to the row below.
+         */
+        int32_t next()
+        {
+          while (next_ <= room_)
+          {
+            ++h_;
+            next_ += nextStep_;
+            nextStep_ += nextStepStep_;
+          }
+          room_ += roomStep_;
+          roomStep_ -= roomStepStep_;
+          return h_;
+        }
+
+      private:
+        int64_t room_;
+        int64_t roomStep_;
+        int64_t roomStepStep_;
+        int64_t next_;
+        int64_t nextStep_;
+        int64_t nextStepStep_;
+        int32_t h_;
+      };
+
+      /*
+       * Fill the rows top to bottom between left and right with rounded corners, the corners are the quarters
+       * of an ellipse with the semi-axes a and b. The rows between the corners are one rectangle.
+       */
+      template <class Target>
+      static void fillRounded(Target &fb, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t a, int32_t b, Framebuffer::NativeColor color)
+      {
+        Rect bounds(left, top, right - left + 1, bottom - top + 1);
+        Rect visible = bounds.intersected(fb.clip_);
+        if (visible.isEmpty())
+        {
+          return;
+        }
+        fb.markDirty(visible);
+
+        fillRect(fb, true, left, top + b, right - left + 1, bottom - top + 1 - 2 * b, color);
+
+        EllipseRows rows(a, b);
+        for (int32_t k = b; k > 0; --k)
+        {
+          int32_t h = rows.next();
+          fillSpan(fb, left + a - h, right - a + h, top + b - k, color);
+          fillSpan(fb, left + a - h, right - a + h, bottom - b + k, color);
+        }
+      }
+
+      /*
+       * The direction vectors of an arc and the bounding rectangle of the filled spans.
+       */
+      struct Arc
+      {
+        bool full;
+        bool convex;
+        int32_t startX;
+        int32_t startY;
+        int32_t endX;
+        int32_t endY;
+        int32_t left;
+        int32_t right;
+        int32_t top;
+        int32_t bottom;
+      };
+
+      /*
+       * The pixels of a row with m * x <= rhs as the interval [left, right].
+       */
+      static void halfPlane(int32_t m, int32_t rhs, int32_t &left, int32_t &right)
+      {
+        left = -UNBOUNDED;
+        right = UNBOUNDED;
+        if (m > 0)
+        {
+          right = rhs >= 0 ? rhs / m : -((m - 1 - rhs) / m);
+        }
+        else if (m < 0)
+        {
+          left = rhs <= 0 ? (-m - 1 - rhs) / -m : -(rhs / -m);
+        }
+        else if (rhs < 0)
+        {
+          left = UNBOUNDED;
+        }
+      }
+
+      /*
+       * Fill the pixels of the row y of an arc. The ring is the interval [-ho, ho] without [-hi, hi], the
+       * sector is the intersection of the half planes left of the start and right of the end direction, or
+       * their union for more than 180 degrees.
+       */
+      template <class Target>
+      static void fillArcRow(Target &fb, Arc &arc, int32_t cx, int32_t y, int32_t dy, int32_t ho, int32_t hi, Framebuffer::NativeColor color)
+      {
+        if (y < fb.clip_.y() || y >= fb.clip_.bottom())
+        {
+          return;
+        }
+
+        int32_t ring[2][2] = {{-ho, hi < 0 ? ho : -hi - 1}, {hi + 1, hi < 0 ? -1 : ho}};
+        int32_t sector[2][2] = {{-UNBOUNDED, UNBOUNDED}, {1, 0}};
+        if (not arc.full)
+        {
+          halfPlane(arc.startY, arc.startX * dy, sector[0][0], sector[0][1]);
+          halfPlane(-arc.endY, -arc.endX * dy, sector[1][0], sector[1][1]);
+          bool overlap = sector[0][0] <= sector[1][1] + 1 && sector[1][0] <= sector[0][1] + 1;
+          if (arc.convex || overlap)
+          {
+            int32_t l = arc.convex ? (sector[0][0] > sector[1][0] ? sector[0][0] : sector[1][0]) : (sector[0][0] < sector[1][0] ? sector[0][0] : sector[1][0]);
+            int32_t r = arc.convex ? (sector[0][1] < sector[1][1] ? sector[0][1] : sector[1][1]) : (sector[0][1] > sector[1][1] ? sector[0][1] : sector[1][1]);
+            sector[0][0] = l;
+            sector[0][1] = r;
+            sector[1][0] = 1;
+            sector[1][1] = 0;
+          }
+        }
+
+        for (auto &r : ring)
+        {
+          for (auto &s : sector)
+          {
+            int32_t l = r[0] > s[0] ? r[0] : s[0];
+            int32_t h = r[1] < s[1] ? r[1] : s[1];
+            if (l > h)
+            {
+              continue;
+            }
+
+            l = cx + l > fb.clip_.x() ? cx + l : fb.clip_.x();
+            h = cx + h < fb.clip_.right() - 1 ? cx + h : fb.clip_.right() - 1;
+            if (l <= h)
+            {
+              fb.fillSpan(l, y, h - l + 1, color);
+              arc.left = l < arc.left ? l : arc.left;
+              arc.right = h > arc.right ? h : arc.right;
+              arc.top = y < arc.top ? y : arc.top;
+              arc.bottom = y > arc.bottom ? y : arc.bottom;
+            }
+          }
+        }
+      }
+
+      static int64_t ceilDiv(int64_t a, int64_t b)
+      {
+        return a >= 0 ? (a + b - 1) / b : -((-a) / b);
+      }
+
+      static int32_t saturate(int32_t v)
+      {
+        return v < INT16_MIN ? INT16_MIN : (v > INT16_MAX ? INT16_MAX : v);
+      }
+
+      /*
+       * Rasterize a line along its major axis a (a1 <= a2) with the minor axis b. The pixel at step k is
+       * b1 +- floor((2 * db * k + da) / (2 * da)), so it only depends on the end points. The clip rectangle
+       * [aMin, aMax] x [bMin, bMax] just limits the range of k, which keeps clipped parts (e.g. bands)
+       * identical to the unclipped line. Consecutive pixels with the same minor coordinate are one span.
+       *
+       * The end points are in the int16_t range, so da, db < 2^16 and the loop runs in 32 bits. Only a line
+       * leaving the clip rectangle needs 64 bit divisions, once in the setup.
+       */
+      template <class Target>
+      static void drawLineRuns(Target &fb, bool steep, int32_t a1, int32_t b1, int32_t a2, int32_t b2, int32_t aMin, int32_t aMax, int32_t bMin, int32_t bMax, Framebuffer::NativeColor color)
+      {
+        int32_t da = a2 - a1;
+        int32_t db = b2 > b1 ? b2 - b1 : b1 - b2;
+        int32_t sb = b2 >= b1 ? 1 : -1;
+        int32_t bLow = b2 > b1 ? b1 : b2;
+        int32_t bHigh = b2 > b1 ? b2 : b1;
+        if (bHigh < bMin || bLow > bMax)
+        {
+          return;
+        }
+
+        int32_t first = aMin - a1 > 0 ? aMin - a1 : 0;
+        int32_t last = aMax - a1 < da ? aMax - a1 : da;
+        if (bLow < bMin || bHigh > bMax)
+        {
+          // the steps whose minor coordinate lies inside [bMin, bMax]
+          int64_t qMin = sb > 0 ? bMin - b1 : b1 - bMax;
+          int64_t qMax = sb > 0 ? bMax - b1 : b1 - bMin;
+          int64_t kMin = ceilDiv(2 * (int64_t)da * qMin - da, 2 * (int64_t)db);
+          int64_t kMax = ceilDiv(2 * (int64_t)da * (qMax + 1) - da, 2 * (int64_t)db) - 1;
+          first = kMin > first ? (int32_t)kMin : first;
+          last = kMax < last ? (int32_t)kMax : last;
+        }
+        if (first > last)
+        {
+          return;
+        }
+
+        // quotient and remainder of (2 * db * first + da) / (2 * da)
+        int32_t denominator = 2 * da;
+        int32_t q = 0;
+        int32_t r = da;
+        if (first > 0)
+        {
+          int64_t n = 2 * (int64_t)db * first + da;
+          q = (int32_t)(n / denominator);
+          r = (int32_t)(n - (int64_t)q * denominator);
+        }
+
+        int32_t a = a1 + first;
+        int32_t aStart = a;
+        int32_t aEnd = a1 + last;
+        int32_t b = b1 + sb * q;
+        int32_t bStart = b;
+        int32_t increment = 2 * db;
+
+        int32_t run = a;
+        for (;;)
+        {
+          bool end = a == aEnd;
+          bool step = false;
+          if (not end)
+          {
+            r += increment;
+            if (r >= denominator)
+            {
+              r -= denominator;
+              step = true;
+            }
+          }
+
+          if (end or step)
+          {
+            if (steep)
+            {
+              fb.fillRect(b, run, 1, a - run + 1, color);
+            }
+            else
+            {
+              fb.fillSpan(run, b, a - run + 1, color);
+            }
+
+            if (end)
+            {
+              break;
+            }
+            run = a + 1;
+            b += sb;
+          }
+          ++a;
+        }
+
+        int32_t bTop = b < bStart ? b : bStart;
+        int32_t bSize = (b < bStart ? bStart - b : b - bStart) + 1;
+        if (steep)
+        {
+          fb.markDirty(Rect(bTop, aStart, bSize, aEnd - aStart + 1));
+        }
+        else
+        {
+          fb.markDirty(Rect(aStart, bTop, aEnd - aStart + 1, bSize));
+        }
+      }
+
+      /*
+       * Copy RGB565 pixels stored high byte first into a span, except pixels with the value key.
+       */
+      template <class Target>
+      static void copyPixels(Target &fb, int32_t x, int32_t y, const uint8_t *pixels, int32_t width, uint32_t key)
+      {
+        if (key == Bitmap::NO_KEY)
+        {
+          fb.copySpan(x, y, width, pixels);
+          return;
+        }
+
+        int32_t i = 0;
+        while (i < width)
+        {
+          for (; i < width && (uint32_t)(pixels[2 * i] << 8 | pixels[2 * i + 1]) == key; ++i)
+          {
+          }
+          int32_t start = i;
+          for (; i < width && (uint32_t)(pixels[2 * i] << 8 | pixels[2 * i + 1]) != key; ++i)
+          {
+          }
+          if (i > start)
+          {
+            fb.copySpan(x + start, y, i - start, pixels + 2 * start);
+          }
+        }
+      }
+
+      /*
+       * Fill a rectangle of a primitive, only clip it if the primitive is partially visible.
+       */
+      template <class Target>
+      static void fillRect(Target &fb, bool clipped, int32_t x, int32_t y, uint32_t width, uint32_t height, Framebuffer::NativeColor color)
+      {
+        if (not clipped)
+        {
+          fb.fillRect(x, y, width, height, color);
+          return;
+        }
+
+        Rect r = Rect(x, y, width, height).intersected(fb.clip_);
+        if (not r.isEmpty())
+        {
+          fb.fillRect(r.x(), r.y(), r.width(), r.height(), color);
+        }
+      }
+
+      /*
+       * Fill the pixels left to right of the row y inside the clip rectangle.
+       */
+      template <class Target>
+      static void fillSpan(Target &fb, int32_t left, int32_t right, int32_t y, Framebuffer::NativeColor color)
+      {
+        const Rect &clip = fb.clip_;
+        left = left > clip.x() ? left : clip.x();
+        right = right < clip.right() - 1 ? right : clip.right() - 1;
+        if (left <= right && y >= clip.y() && y < clip.bottom())
+        {
+          fb.fillSpan(left, y, right - left + 1, color);
+        }
+      }
+    };
+  }
+}
@@ -0,0 +1,166 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /**
+     * @brief A point in viewport coordinates, e.g. a vertex of a polygon.
+     */
+    struct Point
+    {
+      int16_t x;
+      int16_t y;
+    };
+
+    /**
+     * @brief An axis aligned rectangle in framebuffer coordinates.
+     *
+     * The rectangle covers the pixels [x, x + width) and [y, y + height).
+     * A rectangle with a width or height of zero is empty.
+     *
+     * Coordinates are saturated to the int16_t range on construction, so rectangles computed from
+     * far off-screen primitives still clip correctly instead of wrapping around.
+     */
+    class Rect
+    {
+    public:
+      /**
+       * @brief Create an empty rectangle.
+       */
+      Rect() : x_(0), y_(0), width_(0), height_(0)
+      {
+      }
+
+      /**
+       * @brief Create a rectangle.
+       *
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param width The width of the rectangle.
+       * @param height The height of the rectangle, negative values give an empty rectangle.
+       */
+      Rect(int32_t x, int32_t y, int32_t width, int32_t height)
+      {
+        int32_t l = saturate(x);
+        int32_t t = saturate(y);
+        x_ = l;
+        y_ = t;
+        width_ = saturate(l + clampSize(width)) - l;
+        height_ = saturate(t + clampSize(height)) - t;
+      }
+
+      int16_t x() const { return x_; }
+      int16_t y() const { return y_; }
+      uint16_t width() const { return width_; }
+      uint16_t height() const { return height_; }
+
+      /**
+       * @brief Get the X coordinate right of the rectangle (exclusive).
+       */
+      int32_t right() const { return x_ + width_; }
+
+      /**
+       * @brief Get the Y coordinate below the rectangle (exclusive).
+       */
+      int32_t bottom() const { return y_ + height_; }
+
+      /**
+       * @brief Check if the rectangle is empty.
+       * @return True if the rectangle covers no pixel.
+       */
+      bool isEmpty() const
+      {
+        return width_ == 0 || height_ == 0;
+      }
+
+      /**
+       * @brief Check if a point lies inside the rectangle.
+       */
+      bool contains(int32_t x, int32_t y) const
+      {
+        return x >= x_ && x < right() && y >= y_ && y < bottom();
+      }
+
+      /**
+       * @brief Get the smallest rectangle containing this and another rectangle.
+       *
+       * Empty rectangles are ignored.
+       */
+      Rect united(const Rect &rhs) const
+      {
+        if (rhs.isEmpty())
+        {
+          return *this;
+        }
+        if (isEmpty())
+        {
+          return rhs;
+        }
+
+        int32_t l = x_ < rhs.x_ ? x_ : rhs.x_;
+        int32_t t = y_ < rhs.y_ ? y_ : rhs.y_;
+        int32_t r = right() > rhs.right() ? right() : rhs.right();
+        int32_t b = bottom() > rhs.bottom() ? bottom() : rhs.bottom();
+        return Rect(l, t, r - l, b - t, Unchecked());
+      }
+
+      /**
+       * @brief Get the overlapping part of this and another rectangle.
+       * @return The intersection, empty if the rectangles do not overlap.
+       */
+      Rect intersected(const Rect &rhs) const
+      {
+        int32_t l = x_ > rhs.x_ ? x_ : rhs.x_;
+        int32_t t = y_ > rhs.y_ ? y_ : rhs.y_;
+        int32_t r = right() < rhs.right() ? right() : rhs.right();
+        int32_t b = bottom() < rhs.bottom() ? bottom() : rhs.bottom();
+        if (r <= l || b <= t)
+        {
+          return Rect();
+        }
+        return Rect(l, t, r - l, b - t, Unchecked());
+      }
+
+      bool operator==(const Rect &rhs) const
+      {
+        return x_ == rhs.x_ && y_ == rhs.y_ && width_ == rhs.width_ && height_ == rhs.height_;
+      }
+
+    private:
+      struct Unchecked
+      {
+      };
+
+      /*
+       * Create a rectangle from values already in range, e.g. combined from other rectangles.
+       */
+      Rect(int32_t x, int32_t y, int32_t width, int32_t height, Unchecked)
+          : x_(x), y_(y), width_(width), height_(height)
+      {
+      }
+
+      static int32_t saturate(int32_t v)
+      {
+        return v < INT16_MIN ? INT16_MIN : (v > INT16_MAX ? INT16_MAX : v);
+      }
+
+      static int32_t clampSize(int32_t v)
+      {
+        return v < 0 ? 0 : (v > UINT16_MAX ? UINT16_MAX : v);
+      }
+
+      int16_t x_;
+      int16_t y_;
+      uint16_t width_;
+      uint16_t height_;
+    };
+  }
+}
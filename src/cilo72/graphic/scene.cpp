@@ -0,0 +1,186 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include "cilo72/graphic/scene.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    Widget::Widget(const Rect &bounds)
+        : bounds_(bounds), damage_(bounds), visible_(true), shown_(false), retained_(false)
+    {
+    }
+
+    void Widget::setBounds(const Rect &bounds)
+    {
+      damage_ = damage_.united(bounds_).united(bounds);
+      bounds_ = bounds;
+      shown_ = false;
+    }
+
+    void Widget::setVisible(bool visible)
+    {
+      if (visible != visible_)
+      {
+        visible_ = visible;
+        damage_ = bounds_;
+        shown_ = false;
+      }
+    }
+
+    void Widget::invalidate()
+    {
+      damage_ = bounds_;
+    }
+
+    void Widget::invalidate(const Rect &rect)
+    {
+      Rect r(bounds_.x() + rect.x(), bounds_.y() + rect.y(), rect.width(), rect.height());
+      damage_ = damage_.united(r.intersected(bounds_));
+    }
+
+    Scene::Scene(const Color &background)
+        : background_(background), count_(0), damageCount_(0), all_(true)
+    {
+    }
+
+    bool Scene::add(Widget &widget)
+    {
+      if (count_ == MAX_WIDGETS)
+      {
+        return false;
+      }
+
+      widgets_[count_++] = &widget;
+      widget.invalidate();
+      widget.shown_ = false;
+      return true;
+    }
+
+    void Scene::remove(Widget &widget)
+    {
+      for (uint8_t i = 0; i < count_; ++i)
+      {
+        if (widgets_[i] == &widget)
+        {
+          addDamage(widget.damage_.united(widget.bounds_));
+          for (--count_; i < count_; ++i)
+          {
+            widgets_[i] = widgets_[i + 1];
+          }
+          return;
+        }
+      }
+    }
+
+    void Scene::invalidate()
+    {
+      all_ = true;
+    }
+
+    Rect Scene::render(Framebuffer &fb)
+    {
+      bool all = all_;
+      if (all_)
+      {
+        // the whole clip rectangle, relative to the viewport
+        const Rect &clip = fb.clipRect();
+        damageCount_ = 0;
+        addDamage(Rect(clip.x() - fb.originX(), clip.y() - fb.originY(), clip.width(), clip.height()));
+        all_ = false;
+      }
+
+      for (uint8_t i = 0; i < count_; ++i)
+      {
+        addDamage(widgets_[i]->damage_);
+        widgets_[i]->damage_ = Rect();
+      }
+
+      Rect redrawn;
+      for (uint8_t d = 0; d < damageCount_; ++d)
+      {
+        const Rect &damage = damage_[d];
+
+        // the background is hidden if an opaque widget covers the whole rectangle
+        bool covered = false;
+        for (uint8_t i = 0; i < count_ && not covered; ++i)
+        {
+          const Widget &w = *widgets_[i];
+          covered = w.visible_ && w.opaque() && w.bounds_.intersected(damage) == damage;
+        }
+
+        fb.pushViewport(damage);
+        if (not covered)
+        {
+          fb.drawSquare(0, 0, damage.width(), damage.height(), background_);
+        }
+        for (uint8_t i = 0; i < count_; ++i)
+        {
+          Widget &w = *widgets_[i];
+          if (w.visible_ && not w.bounds_.intersected(damage).isEmpty())
+          {
+            // the previous pixels survive if neither the background nor another widget was drawn over them
+            bool alone = this->alone(w);
+            bool inside = w.bounds_.intersected(damage) == damage;
+            w.retained_ = w.shown_ && not all && alone && inside && w.opaque();
+
+            fb.pushViewport(Rect(w.bounds_.x() - damage.x(), w.bounds_.y() - damage.y(), w.bounds_.width(), w.bounds_.height()));
+            w.draw(fb);
+            fb.popViewport();
+
+            w.retained_ = false;
+            w.shown_ = alone && ((w.shown_ && not all) || w.bounds_.intersected(damage) == w.bounds_);
+          }
+        }
+        fb.popViewport();
+        redrawn = redrawn.united(damage);
+      }
+
+      damageCount_ = 0;
+      return redrawn;
+    }
+
+    bool Scene::alone(const Widget &widget) const
+    {
+      for (uint8_t i = 0; i < count_; ++i)
+      {
+        const Widget &w = *widgets_[i];
+        if (&w != &widget && w.visible_ && not w.bounds_.intersected(widget.bounds_).isEmpty())
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    void Scene::addDamage(const Rect &rect)
+    {
+      if (rect.isEmpty())
+      {
+        return;
+      }
+
+      // merge overlapping rectangles, so no pixel is drawn twice, and fold into an existing one if the list is full
+      Rect r = rect;
+      bool merged = true;
+      while (merged)
+      {
+        merged = false;
+        for (uint8_t i = 0; i < damageCount_; ++i)
+        {
+          if (damageCount_ == MAX_DAMAGE || not damage_[i].intersected(r).isEmpty())
+          {
+            r = r.united(damage_[i]);
+            damage_[i] = damage_[--damageCount_];
+            merged = true;
+            break;
+          }
+        }
+      }
+      damage_[damageCount_++] = r;
+    }
+  }
+}
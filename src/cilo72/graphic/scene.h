@@ -0,0 +1,166 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "framebuffer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief An element of a Scene with a rectangle on the screen.
+     *
+     * A widget collects the parts of its rectangle that changed, e.g. a setter invalidates only the pixels that
+     * look different after the change. Scene::render() draws these parts again.
+     */
+    class Widget
+    {
+    public:
+      /*!
+       * @brief Create a widget.
+       * @param bounds The rectangle of the widget relative to the viewport of the scene.
+       */
+      explicit Widget(const Rect &bounds);
+
+      /*!
+       * @brief Get the rectangle of the widget relative to the viewport of the scene.
+       */
+      const Rect &bounds() const { return bounds_; }
+
+      /*!
+       * @brief Move or resize the widget, the old and the new rectangle are redrawn.
+       * @param bounds The new rectangle.
+       */
+      virtual void setBounds(const Rect &bounds);
+
+      /*!
+       * @brief Check if the widget is drawn.
+       */
+      bool visible() const { return visible_; }
+
+      /*!
+       * @brief Show or hide the widget.
+       * @param visible False to hide the widget, the widgets below it and the background are drawn instead.
+       */
+      void setVisible(bool visible);
+
+      /*!
+       * @brief Redraw the whole widget with the next Scene::render().
+       */
+      void invalidate();
+
+      /*!
+       * @brief Redraw a part of the widget with the next Scene::render().
+       * @param rect The part relative to the top-left corner of the widget.
+       */
+      void invalidate(const Rect &rect);
+
+      /*!
+       * @brief Check if a part of the widget waits to be redrawn.
+       */
+      bool dirty() const { return not damage_.isEmpty(); }
+
+      /*!
+       * @brief Check if draw() sets every pixel of the rectangle, so the scene does not fill the background first.
+       */
+      virtual bool opaque() const { return false; }
+
+    protected:
+      /*!
+       * @brief Draw the widget.
+       *
+       * The origin of the viewport is the top-left corner of the widget and the clip rectangle is the part
+       * to redraw. Everything inside the clip rectangle has to be drawn, not only the parts that changed.
+       *
+       * @param fb The framebuffer.
+       */
+      virtual void draw(Framebuffer &fb) = 0;
+
+      /*!
+       * @brief Check if the framebuffer still holds the pixels of the previous draw() inside the clip rectangle.
+       *
+       * This is the case if the clip rectangle lies inside an opaque widget that no other widget overlaps, so
+       * draw() may move the pixels, e.g. scroll, instead of drawing them again.
+       */
+      bool retained() const { return retained_; }
+
+    private:
+      friend class Scene;
+
+      Rect bounds_;
+      Rect damage_;
+      bool visible_;
+      bool shown_;
+      bool retained_;
+    };
+
+    /*!
+     * @brief Widgets in z-order that are redrawn only where they changed.
+     *
+     * Instead of clearing and drawing the whole screen every loop, the widgets are kept and render() redraws
+     * the invalidated rectangles: the background and all visible widgets overlapping a rectangle, bottom to top,
+     * clipped to it. Overlapping rectangles are merged, so no pixel is drawn twice per widget. The modified
+     * pixels are part of the dirty region of the framebuffer, so the display driver transfers only them:
+     *
+     *   label.setText(...);
+     *   bar.setValue(...);
+     *   scene.render(fb);
+     *   display.updateDirty();
+     *
+     * The widgets are referenced, they have to outlive the scene.
+     */
+    class Scene
+    {
+    public:
+      static constexpr uint8_t MAX_WIDGETS = 32; //< Maximum number of widgets.
+      static constexpr uint8_t MAX_DAMAGE = 8;   //< Maximum number of separately redrawn rectangles.
+
+      /*!
+       * @brief Create an empty scene, the first render() draws the whole viewport.
+       * @param background The color of the pixels not covered by a widget.
+       */
+      explicit Scene(const Color &background = Color(0, 0, 0));
+
+      /*!
+       * @brief Add a widget on top of the other widgets.
+       * @param widget The widget, drawn with the next render().
+       * @return False if the scene is full.
+       */
+      bool add(Widget &widget);
+
+      /*!
+       * @brief Remove a widget, its rectangle is redrawn with the next render().
+       * @param widget The widget.
+       */
+      void remove(Widget &widget);
+
+      /*!
+       * @brief Redraw everything with the next render(), e.g. after the framebuffer was cleared.
+       */
+      void invalidate();
+
+      /*!
+       * @brief Redraw the invalidated parts of the scene.
+       * @param fb The framebuffer, the scene is drawn relative to its current viewport.
+       * @return The bounding rectangle of the redrawn parts relative to the viewport, empty if nothing changed.
+       */
+      Rect render(Framebuffer &fb);
+
+    private:
+      void addDamage(const Rect &rect);
+      bool alone(const Widget &widget) const;
+
+      Widget *widgets_[MAX_WIDGETS];
+      Rect damage_[MAX_DAMAGE];
+      Color background_;
+      uint8_t count_;
+      uint8_t damageCount_;
+      bool all_;
+    };
+  }
+}
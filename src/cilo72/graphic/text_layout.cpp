@@ -0,0 +1,227 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include "cilo72/graphic/text_layout.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    namespace
+    {
+      constexpr uint16_t NO_BREAK = UINT16_MAX;
+
+      /*
+       * FNV-1a hash, detects changes of a text modified in place.
+       */
+      uint32_t hash(const char *s)
+      {
+        uint32_t h = 2166136261u;
+        for (; *s; ++s)
+        {
+          h = (h ^ (uint8_t)*s) * 16777619u;
+        }
+        return h;
+      }
+    }
+
+    TextLayout::TextLayout(const Rect &box, const cilo72::fonts::Font &font, uint32_t scale, Framebuffer::Position alignment, uint8_t lineSpacing)
+        : TextLayout(box, &font, nullptr, scale, alignment, lineSpacing)
+    {
+    }
+
+    TextLayout::TextLayout(const Rect &box, const cilo72::fonts::ProportionalFont &font, uint32_t scale, Framebuffer::Position alignment, uint8_t lineSpacing)
+        : TextLayout(box, nullptr, &font, scale, alignment, lineSpacing)
+    {
+    }
+
+    TextLayout::TextLayout(const Rect &box, const cilo72::fonts::Font *font, const cilo72::fonts::ProportionalFont *proportional, uint32_t scale, Framebuffer::Position alignment, uint8_t lineSpacing)
+        : font_(font), proportional_(proportional), text_(nullptr), hash_(0), box_(box), scale_(scale)
+        , advance_(font ? (font->width() + font->spacingPerChar()) * scale : 0)
+        , lineHeight_((font ? font->height() : proportional->height()) * scale + lineSpacing)
+        , top_(0), alignment_(alignment), lineSpacing_(lineSpacing), count_(0), truncated_(false)
+    {
+    }
+
+    bool TextLayout::setText(const char *text)
+    {
+      uint32_t h = hash(text);
+      if (text == text_ && h == hash_)
+      {
+        return false;
+      }
+
+      text_ = text;
+      hash_ = h;
+      layout();
+      return true;
+    }
+
+    void TextLayout::setBox(const Rect &box)
+    {
+      box_ = box;
+      layout();
+    }
+
+    void TextLayout::draw(Framebuffer &fb, const Color &color) const
+    {
+      fb.pushViewport(box_);
+      for (uint8_t i = 0; i < count_; ++i)
+      {
+        const Line &line = lines_[i];
+        int32_t y = top_ + i * lineHeight_;
+        if (font_)
+        {
+          fb.drawText(line.x, y, scale_, text_ + line.start, line.length, color, *font_);
+        }
+        else
+        {
+          fb.drawText(line.x, y, scale_, text_ + line.start, line.length, color, *proportional_);
+        }
+      }
+      fb.popViewport();
+    }
+
+    void TextLayout::draw(Framebuffer &fb, const Color &color, const Color &background) const
+    {
+      fb.drawSquare(box_.x(), box_.y(), box_.width(), box_.height(), background);
+      draw(fb, color);
+    }
+
+    int32_t TextLayout::advance(char c) const
+    {
+      return font_ ? advance_ : proportional_->advance(c) * scale_;
+    }
+
+    int32_t TextLayout::glyphWidth(char c) const
+    {
+      return font_ ? font_->width() * scale_ : proportional_->advance(c) * scale_;
+    }
+
+    bool TextLayout::addLine(uint16_t start, uint16_t end, int32_t width)
+    {
+      if (count_ == MAX_LINES || (count_ + 1) * lineHeight_ - lineSpacing_ > box_.height())
+      {
+        truncated_ = true;
+        return false;
+      }
+
+      // the spacing after the last character of a fixed width font is not part of the line
+      if (font_ && end > start)
+      {
+        width -= font_->spacingPerChar() * scale_;
+      }
+      lines_[count_++] = {start, (uint16_t)(end - start), 0, (uint16_t)width};
+      return true;
+    }
+
+    void TextLayout::layout()
+    {
+      count_ = 0;
+      truncated_ = false;
+      bounds_ = Rect();
+      if (text_ == nullptr)
+      {
+        return;
+      }
+
+      // one pass over the text, pen is the width of the current line up to character i
+      uint16_t start = 0;
+      uint16_t breakAt = NO_BREAK;
+      int32_t pen = 0;
+      int32_t penAtBreak = 0;
+      for (uint16_t i = 0;; ++i)
+      {
+        char c = text_[i];
+        if (c == '\0' || c == '\n')
+        {
+          if (not addLine(start, i, pen) || c == '\0')
+          {
+            break;
+          }
+          start = i + 1;
+          breakAt = NO_BREAK;
+          pen = 0;
+          continue;
+        }
+
+        if (c == ' ')
+        {
+          breakAt = i;
+          penAtBreak = pen;
+        }
+
+        bool full = false;
+        while (i > start && pen + glyphWidth(c) > box_.width() && not full)
+        {
+          if (breakAt != NO_BREAK && breakAt > start)
+          {
+            // wrap at the last space, the space itself is dropped
+            full = not addLine(start, breakAt, penAtBreak);
+            pen -= penAtBreak + advance(' ');
+            start = breakAt + 1;
+          }
+          else
+          {
+            // a word wider than the box
+            full = not addLine(start, i, pen);
+            pen = 0;
+            start = i;
+          }
+          breakAt = NO_BREAK;
+        }
+
+        if (full)
+        {
+          break;
+        }
+        pen += advance(c);
+      }
+
+      int32_t height = count_ > 0 ? count_ * lineHeight_ - lineSpacing_ : 0;
+      switch (alignment_)
+      {
+      case Framebuffer::TopLeft:
+      case Framebuffer::TopRight:
+        top_ = 0;
+        break;
+
+      case Framebuffer::BottomLeft:
+      case Framebuffer::BottomRight:
+        top_ = box_.height() - height;
+        break;
+
+      default:
+        top_ = (box_.height() - height) / 2;
+        break;
+      }
+
+      for (uint8_t i = 0; i < count_; ++i)
+      {
+        Line &line = lines_[i];
+        switch (alignment_)
+        {
+        case Framebuffer::TopLeft:
+        case Framebuffer::BottomLeft:
+        case Framebuffer::CenterLeft:
+          line.x = 0;
+          break;
+
+        case Framebuffer::TopRight:
+        case Framebuffer::BottomRight:
+        case Framebuffer::CenterRight:
+          line.x = box_.width() - line.width;
+          break;
+
+        case Framebuffer::Center:
+          line.x = (box_.width() - line.width) / 2;
+          break;
+        }
+
+        bounds_ = bounds_.united(Rect(box_.x() + line.x, box_.y() + top_ + i * lineHeight_, line.width, lineHeight_ - lineSpacing_));
+      }
+    }
+  }
+}
@@ -0,0 +1,131 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "framebuffer.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A text wrapped into a box.
+     *
+     * setText() measures the text once and breaks it into lines at spaces and newlines, words wider than the
+     * box are broken between characters. The lines are aligned in the box and drawn by draw() without measuring
+     * them again, until the text changes. Lines that do not fit into the box are dropped.
+     *
+     * The text is referenced, it has to outlive the layout. Changes of the text in place are detected by
+     * setText() as well.
+     */
+    class TextLayout
+    {
+    public:
+      static constexpr uint8_t MAX_LINES = 8; //< Maximum number of lines.
+
+      /*!
+       * @brief Create a layout for a fixed width font.
+       * @param box The box relative to the viewport the text is drawn in.
+       * @param font The font, it has to outlive the layout.
+       * @param scale The character scaling factor.
+       * @param alignment The alignment of the lines in the box.
+       * @param lineSpacing The number of pixels between two lines.
+       */
+      TextLayout(const Rect &box, const cilo72::fonts::Font &font, uint32_t scale = 1, Framebuffer::Position alignment = Framebuffer::TopLeft, uint8_t lineSpacing = 1);
+
+      /*!
+       * @brief Create a layout for a proportional font.
+       * @param box The box relative to the viewport the text is drawn in.
+       * @param font The font, it has to outlive the layout.
+       * @param scale The character scaling factor.
+       * @param alignment The alignment of the lines in the box.
+       * @param lineSpacing The number of pixels between two lines.
+       */
+      TextLayout(const Rect &box, const cilo72::fonts::ProportionalFont &font, uint32_t scale = 1, Framebuffer::Position alignment = Framebuffer::TopLeft, uint8_t lineSpacing = 1);
+
+      /*!
+       * @brief Set the text and lay it out if it differs from the current text.
+       * @param text The text, it has to outlive the layout.
+       * @return True if the layout changed.
+       */
+      bool setText(const char *text);
+
+      /*!
+       * @brief Move or resize the box and lay out the text again.
+       * @param box The new box.
+       */
+      void setBox(const Rect &box);
+
+      /*!
+       * @brief Draw the lines, clipped to the box.
+       * @param fb The framebuffer.
+       * @param color The color of the text.
+       */
+      void draw(Framebuffer &fb, const Color &color) const;
+
+      /*!
+       * @brief Fill the box and draw the lines, so the remains of a previous text are removed in the same pass.
+       * @param fb The framebuffer.
+       * @param color The color of the text.
+       * @param background The color of the box.
+       */
+      void draw(Framebuffer &fb, const Color &color, const Color &background) const;
+
+      /*!
+       * @brief Get the number of lines.
+       */
+      uint8_t lines() const { return count_; }
+
+      /*!
+       * @brief Check if lines were dropped because they did not fit into the box.
+       */
+      bool truncated() const { return truncated_; }
+
+      /*!
+       * @brief Get the bounding rectangle of the lines relative to the viewport.
+       */
+      const Rect &bounds() const { return bounds_; }
+
+      /*!
+       * @brief Get the box.
+       */
+      const Rect &box() const { return box_; }
+
+    private:
+      struct Line
+      {
+        uint16_t start;
+        uint16_t length;
+        int16_t x;
+        uint16_t width;
+      };
+
+      TextLayout(const Rect &box, const cilo72::fonts::Font *font, const cilo72::fonts::ProportionalFont *proportional, uint32_t scale, Framebuffer::Position alignment, uint8_t lineSpacing);
+
+      int32_t advance(char c) const;
+      int32_t glyphWidth(char c) const;
+      bool addLine(uint16_t start, uint16_t end, int32_t width);
+      void layout();
+
+      const cilo72::fonts::Font *font_;
+      const cilo72::fonts::ProportionalFont *proportional_;
+      const char *text_;
+      uint32_t hash_;
+      Rect box_;
+      Rect bounds_;
+      uint32_t scale_;
+      int32_t advance_;
+      int32_t lineHeight_;
+      int32_t top_;
+      Framebuffer::Position alignment_;
+      uint8_t lineSpacing_;
+      uint8_t count_;
+      bool truncated_;
+      Line lines_[MAX_LINES];
+    };
+  }
+}
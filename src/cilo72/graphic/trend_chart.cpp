@@ -0,0 +1,206 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <assert.h>
+#include "cilo72/graphic/trend_chart.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    TrendChart::TrendChart(const Rect &bounds)
+        : Widget(bounds), columns_(bounds.width() < MAX_SAMPLES ? bounds.width() : MAX_SAMPLES), head_(0), count_(0), pending_(0)
+        , dataMin_(0), dataMax_(0), low_(0), high_(0), factor_(0), shift_(0), auto_(true), redraw_(true)
+        , color_(Color::white), background_(0, 0, 0)
+    {
+      clear();
+    }
+
+    void TrendChart::append(int32_t sample)
+    {
+      if (columns_ == 0)
+      {
+        return;
+      }
+
+      bool full = count_ == columns_;
+      int32_t evicted = full ? samples_[head_] : 0;
+      samples_[head_] = sample;
+      head_ = head_ + 1 == columns_ ? 0 : head_ + 1;
+      count_ += full ? 0 : 1;
+      pending_ += pending_ < columns_ ? 1 : 0;
+
+      if (count_ == 1)
+      {
+        dataMin_ = sample;
+        dataMax_ = sample;
+      }
+      else if (full && (evicted == dataMin_ || evicted == dataMax_))
+      {
+        findExtremes();
+      }
+      else
+      {
+        dataMin_ = sample < dataMin_ ? sample : dataMin_;
+        dataMax_ = sample > dataMax_ ? sample : dataMax_;
+      }
+
+      scale(false);
+      invalidate();
+    }
+
+    void TrendChart::clear()
+    {
+      head_ = 0;
+      count_ = 0;
+      pending_ = 0;
+      dataMin_ = 0;
+      dataMax_ = 0;
+      scale(true);
+      invalidate();
+    }
+
+    void TrendChart::setRange(int32_t minimum, int32_t maximum)
+    {
+      assert(maximum > minimum);
+
+      auto_ = false;
+      low_ = minimum;
+      high_ = maximum;
+      scale(true);
+      invalidate();
+    }
+
+    void TrendChart::setAutoScale()
+    {
+      auto_ = true;
+      scale(true);
+      invalidate();
+    }
+
+    void TrendChart::setColors(const Color &color, const Color &background)
+    {
+      color_ = color;
+      background_ = background;
+      redraw_ = true;
+      invalidate();
+    }
+
+    void TrendChart::setBounds(const Rect &bounds)
+    {
+      Widget::setBounds(bounds);
+      columns_ = bounds.width() < MAX_SAMPLES ? bounds.width() : MAX_SAMPLES;
+      clear();
+    }
+
+    void TrendChart::draw(Framebuffer &fb)
+    {
+      int32_t width = bounds().width();
+      int32_t height = bounds().height();
+      if (retained() && not redraw_ && pending_ < count_)
+      {
+        // move the columns that stay in the plot left by the new samples, the uncovered ones are filled with the
+        // background, columns left of the plot are empty if the chart is wider than MAX_SAMPLES
+        if (pending_ > 0)
+        {
+          fb.moveRect(Rect(width - count_ + pending_, 0, count_ - pending_, height), width - count_, 0, background_);
+          drawColumns(fb, count_ - pending_);
+
+          // the oldest column was connected to an evicted sample, it becomes a single point like in a full redraw
+          if (count_ == columns_)
+          {
+            int32_t x = width - count_;
+            int32_t y = row(samples_[head_]);
+            fb.drawSquare(x, 0, 1, height, background_);
+            fb.drawSquare(x, y, 1, 1, color_);
+          }
+        }
+      }
+      else
+      {
+        fb.drawSquare(0, 0, width, height, background_);
+        if (count_ > 0)
+        {
+          drawColumns(fb, 0);
+        }
+      }
+
+      pending_ = 0;
+      redraw_ = false;
+    }
+
+    void TrendChart::findExtremes()
+    {
+      // the buffer is filled from index 0, so the first count_ entries are the samples
+      dataMin_ = samples_[0];
+      dataMax_ = samples_[0];
+      for (uint16_t i = 1; i < count_; ++i)
+      {
+        dataMin_ = samples_[i] < dataMin_ ? samples_[i] : dataMin_;
+        dataMax_ = samples_[i] > dataMax_ ? samples_[i] : dataMax_;
+      }
+    }
+
+    void TrendChart::scale(bool force)
+    {
+      uint32_t range = (uint32_t)dataMax_ - (uint32_t)dataMin_;
+      if (not force)
+      {
+        uint32_t shown = (uint32_t)high_ - (uint32_t)low_;
+        if (not auto_ || (dataMin_ >= low_ && dataMax_ <= high_ && range >= shown / 4))
+        {
+          return;
+        }
+      }
+
+      if (auto_)
+      {
+        int64_t margin = range / 8 + 1;
+        int64_t low = (int64_t)dataMin_ - margin;
+        int64_t high = (int64_t)dataMax_ + margin;
+        low_ = low < INT32_MIN ? INT32_MIN : (int32_t)low;
+        high_ = high > INT32_MAX ? INT32_MAX : (int32_t)high;
+      }
+
+      // reduce the span to 16 bits, so (offset >> shift_) * factor_ stays below rows << 16
+      uint32_t span = (uint32_t)high_ - (uint32_t)low_;
+      uint32_t rows = bounds().height() > 0 ? bounds().height() - 1 : 0;
+      shift_ = 0;
+      while ((span >> shift_) > 0xFFFF)
+      {
+        ++shift_;
+      }
+      factor_ = (rows << 16) / (span >> shift_);
+      redraw_ = true;
+    }
+
+    int32_t TrendChart::row(int32_t sample) const
+    {
+      uint32_t span = (uint32_t)high_ - (uint32_t)low_;
+      uint32_t offset = sample <= low_ ? 0 : (sample >= high_ ? span : (uint32_t)sample - (uint32_t)low_);
+      return (int32_t)(bounds().height() - 1) - (int32_t)(((offset >> shift_) * factor_) >> 16);
+    }
+
+    void TrendChart::drawColumns(Framebuffer &fb, uint16_t first)
+    {
+      int32_t x = bounds().width() - count_ + first;
+      uint16_t index = head_ + columns_ - count_ + first;
+      index = index >= columns_ ? index - columns_ : index;
+
+      // each column connects the previous sample with the current one
+      uint16_t previous = first == 0 ? index : (index == 0 ? columns_ - 1 : index - 1);
+      int32_t last = row(samples_[previous]);
+      for (uint16_t i = first; i < count_; ++i, ++x)
+      {
+        int32_t current = row(samples_[index]);
+        int32_t top = current < last ? current : last;
+        int32_t bottom = current < last ? last : current;
+        fb.drawSquare(x, top, 1, bottom - top + 1, color_);
+        last = current;
+        index = index + 1 == columns_ ? 0 : index + 1;
+      }
+    }
+  }
+}
@@ -0,0 +1,119 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "scene.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A strip chart of the latest samples, one sample per column, the newest at the right edge.
+     *
+     * The samples are kept in a ring buffer with one entry per column. Appending a sample moves the plot one
+     * column to the left with a block move of the framebuffer and draws only the new column, a vertical span from
+     * the previous to the new sample. The whole chart is redrawn only if the scale changes or its pixels were
+     * overdrawn, see Widget::retained(). Samples appended between two renders are drawn together.
+     *
+     * The automatic scale follows the minimum and maximum of the buffered samples. They are updated with each
+     * sample and searched again only when the evicted sample was an extreme. The scale grows by 1/8 of the data
+     * range on both sides and shrinks only when the data uses less than a quarter of it, so a noisy signal does
+     * not rescale the chart with every sample. The mapping to rows uses a Q16 factor, there is no division per
+     * sample.
+     */
+    class TrendChart : public Widget
+    {
+    public:
+      static constexpr uint16_t MAX_SAMPLES = 160; //< Maximum number of buffered samples, columns beyond are empty.
+
+      /*!
+       * @brief Create an empty chart with automatic scale.
+       * @param bounds The plot area, one column per sample.
+       */
+      explicit TrendChart(const Rect &bounds);
+
+      /*!
+       * @brief Append a sample, the oldest one is dropped if the buffer is full.
+       * @param sample The sample.
+       */
+      void append(int32_t sample);
+
+      /*!
+       * @brief Remove all samples.
+       */
+      void clear();
+
+      /*!
+       * @brief Use a fixed scale, samples outside are drawn at the edges.
+       * @param minimum The sample at the bottom row.
+       * @param maximum The sample at the top row, greater than minimum.
+       */
+      void setRange(int32_t minimum, int32_t maximum);
+
+      /*!
+       * @brief Scale to the buffered samples.
+       */
+      void setAutoScale();
+
+      /*!
+       * @brief Get the sample at the bottom row.
+       */
+      int32_t minimum() const { return low_; }
+
+      /*!
+       * @brief Get the sample at the top row.
+       */
+      int32_t maximum() const { return high_; }
+
+      /*!
+       * @brief Get the number of buffered samples.
+       */
+      uint16_t count() const { return count_; }
+
+      /*!
+       * @brief Set the colors and redraw the chart.
+       * @param color The color of the trace.
+       * @param background The color of the plot area.
+       */
+      void setColors(const Color &color, const Color &background);
+
+      /*!
+       * @brief Move or resize the chart, a new width removes all samples.
+       * @param bounds The new plot area.
+       */
+      void setBounds(const Rect &bounds) override;
+
+      bool opaque() const override { return true; }
+
+    protected:
+      void draw(Framebuffer &fb) override;
+
+    private:
+      void findExtremes();
+      void scale(bool force);
+      int32_t row(int32_t sample) const;
+      void drawColumns(Framebuffer &fb, uint16_t first);
+
+      int32_t samples_[MAX_SAMPLES];
+      uint16_t columns_;
+      uint16_t head_;
+      uint16_t count_;
+      uint16_t pending_;
+      int32_t dataMin_;
+      int32_t dataMax_;
+      int32_t low_;
+      int32_t high_;
+      uint32_t factor_;
+      uint8_t shift_;
+      bool auto_;
+      bool redraw_;
+      Color color_;
+      Color background_;
+    };
+  }
+}
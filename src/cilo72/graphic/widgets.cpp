@@ -0,0 +1,171 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include <assert.h>
+#include "cilo72/graphic/widgets.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    Label::Label(const Rect &bounds, const cilo72::fonts::Font &font, uint32_t scale, Framebuffer::Position alignment)
+        : Widget(bounds), layout_(Rect(0, 0, bounds.width(), bounds.height()), font, scale, alignment)
+        , color_(Color::white), background_(0, 0, 0)
+    {
+    }
+
+    Label::Label(const Rect &bounds, const cilo72::fonts::ProportionalFont &font, uint32_t scale, Framebuffer::Position alignment)
+        : Widget(bounds), layout_(Rect(0, 0, bounds.width(), bounds.height()), font, scale, alignment)
+        , color_(Color::white), background_(0, 0, 0)
+    {
+    }
+
+    void Label::setText(const char *text)
+    {
+      // the layout box starts at the top-left corner of the widget, so its bounds are widget coordinates
+      Rect before = layout_.bounds();
+      if (layout_.setText(text))
+      {
+        invalidate(before.united(layout_.bounds()));
+      }
+    }
+
+    void Label::setColors(const Color &color, const Color &background)
+    {
+      color_ = color;
+      background_ = background;
+      invalidate();
+    }
+
+    void Label::setBounds(const Rect &bounds)
+    {
+      Widget::setBounds(bounds);
+      layout_.setBox(Rect(0, 0, bounds.width(), bounds.height()));
+    }
+
+    void Label::draw(Framebuffer &fb)
+    {
+      layout_.draw(fb, color_, background_);
+    }
+
+    NumericLabel::NumericLabel(int32_t x, int32_t y, uint8_t cells, const cilo72::fonts::Font &font, uint32_t scale, uint8_t decimals)
+        : Widget(Rect(x, y, cells * (font.width() + font.spacingPerChar()) * scale, font.height() * scale))
+        , field_(0, 0, cells, font, scale, decimals)
+    {
+    }
+
+    void NumericLabel::setValue(int32_t value)
+    {
+      field_.setValue(value);
+      invalidate(field_.damage());
+    }
+
+    void NumericLabel::setColors(const Color &color, const Color &background)
+    {
+      field_.setColors(color, background);
+      invalidate();
+    }
+
+    void NumericLabel::draw(Framebuffer &fb)
+    {
+      // the clip rectangle may cut through cells, draw them all and let the clipping skip the rest
+      field_.invalidate();
+      field_.draw(fb);
+    }
+
+    Bar::Bar(const Rect &bounds, int32_t minimum, int32_t maximum, bool vertical)
+        : Widget(bounds), minimum_(minimum), maximum_(maximum), value_(minimum), level_(0), vertical_(vertical)
+        , color_(Color::white), background_(0, 0, 0)
+    {
+      assert(maximum > minimum);
+    }
+
+    void Bar::setValue(int32_t value)
+    {
+      value_ = value < minimum_ ? minimum_ : (value > maximum_ ? maximum_ : value);
+
+      int32_t level = this->level(value_);
+      if (level == level_)
+      {
+        return;
+      }
+
+      int32_t low = level < level_ ? level : level_;
+      int32_t high = level < level_ ? level_ : level;
+      level_ = level;
+      if (vertical_)
+      {
+        int32_t height = bounds().height();
+        invalidate(Rect(0, height - high, bounds().width(), high - low));
+      }
+      else
+      {
+        invalidate(Rect(low, 0, high - low, bounds().height()));
+      }
+    }
+
+    void Bar::setColors(const Color &color, const Color &background)
+    {
+      color_ = color;
+      background_ = background;
+      invalidate();
+    }
+
+    void Bar::setBounds(const Rect &bounds)
+    {
+      Widget::setBounds(bounds);
+      level_ = level(value_);
+    }
+
+    void Bar::draw(Framebuffer &fb)
+    {
+      uint32_t width = bounds().width();
+      uint32_t height = bounds().height();
+      if (vertical_)
+      {
+        fb.drawSquare(0, 0, width, height - level_, background_);
+        fb.drawSquare(0, height - level_, width, level_, color_);
+      }
+      else
+      {
+        fb.drawSquare(0, 0, level_, height, color_);
+        fb.drawSquare(level_, 0, width - level_, height, background_);
+      }
+    }
+
+    int32_t Bar::level(int32_t value) const
+    {
+      int64_t length = vertical_ ? bounds().height() : bounds().width();
+      return (int32_t)(((int64_t)value - minimum_) * length / ((int64_t)maximum_ - minimum_));
+    }
+
+    Icon::Icon(int32_t x, int32_t y, const Bitmap &bitmap, const Color &color)
+        : Widget(Rect(x, y, bitmap.width(), bitmap.height())), bitmap_(bitmap), color_(color)
+    {
+    }
+
+    void Icon::setBitmap(const Bitmap &bitmap)
+    {
+      bitmap_ = bitmap;
+      setBounds(Rect(bounds().x(), bounds().y(), bitmap.width(), bitmap.height()));
+    }
+
+    void Icon::setColor(const Color &color)
+    {
+      color_ = color;
+      invalidate();
+    }
+
+    bool Icon::opaque() const
+    {
+      return bitmap_.format() != Bitmap::Format::Monochrome && not bitmap_.hasKey();
+    }
+
+    void Icon::draw(Framebuffer &fb)
+    {
+      fb.blit(0, 0, bitmap_, color_);
+    }
+  }
+}
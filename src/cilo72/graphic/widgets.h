@@ -0,0 +1,199 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "bitmap.h"
+#include "numeric_field.h"
+#include "scene.h"
+#include "text_layout.h"
+
+namespace cilo72
+{
+  namespace graphic
+  {
+    /*!
+     * @brief A text in a box, see TextLayout. Changing the text redraws the old and the new lines.
+     */
+    class Label : public Widget
+    {
+    public:
+      /*!
+       * @brief Create a label with a fixed width font.
+       * @param bounds The box of the text.
+       * @param font The font, it has to outlive the label.
+       * @param scale The character scaling factor.
+       * @param alignment The position of the text in the box.
+       */
+      Label(const Rect &bounds, const cilo72::fonts::Font &font, uint32_t scale = 1, Framebuffer::Position alignment = Framebuffer::TopLeft);
+
+      /*!
+       * @brief Create a label with a proportional font.
+       * @param bounds The box of the text.
+       * @param font The font, it has to outlive the label.
+       * @param scale The character scaling factor.
+       * @param alignment The position of the text in the box.
+       */
+      Label(const Rect &bounds, const cilo72::fonts::ProportionalFont &font, uint32_t scale = 1, Framebuffer::Position alignment = Framebuffer::TopLeft);
+
+      /*!
+       * @brief Set the text, nothing is redrawn if it did not change.
+       * @param text The text, it has to outlive the label.
+       */
+      void setText(const char *text);
+
+      /*!
+       * @brief Set the colors and redraw the label.
+       * @param color The color of the text.
+       * @param background The color of the box.
+       */
+      void setColors(const Color &color, const Color &background);
+
+      void setBounds(const Rect &bounds) override;
+      bool opaque() const override { return true; }
+
+    protected:
+      void draw(Framebuffer &fb) override;
+
+    private:
+      TextLayout layout_;
+      Color color_;
+      Color background_;
+    };
+
+    /*!
+     * @brief A NumericField as widget, a new value redraws only the character cells that changed.
+     */
+    class NumericLabel : public Widget
+    {
+    public:
+      /*!
+       * @brief Create a numeric label.
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param cells The number of characters including sign and decimal point.
+       * @param font The fixed width font, it has to outlive the label.
+       * @param scale The character scaling factor.
+       * @param decimals The number of digits after the decimal point.
+       */
+      NumericLabel(int32_t x, int32_t y, uint8_t cells, const cilo72::fonts::Font &font, uint32_t scale = 1, uint8_t decimals = 0);
+
+      /*!
+       * @brief Set the value.
+       * @param value The value, scaled by 10 ^ decimals.
+       */
+      void setValue(int32_t value);
+
+      /*!
+       * @brief Get the value.
+       */
+      int32_t value() const { return field_.value(); }
+
+      /*!
+       * @brief Set the colors and redraw the label.
+       * @param color The color of the characters.
+       * @param background The color of the cells.
+       */
+      void setColors(const Color &color, const Color &background);
+
+      bool opaque() const override { return true; }
+
+    protected:
+      void draw(Framebuffer &fb) override;
+
+    private:
+      NumericField field_;
+    };
+
+    /*!
+     * @brief A bar graph, a new value redraws only the pixels between the old and the new level.
+     */
+    class Bar : public Widget
+    {
+    public:
+      /*!
+       * @brief Create a bar.
+       * @param bounds The rectangle of the bar.
+       * @param minimum The value of an empty bar.
+       * @param maximum The value of a full bar, greater than minimum.
+       * @param vertical True to fill from the bottom to the top, otherwise from the left to the right.
+       */
+      Bar(const Rect &bounds, int32_t minimum, int32_t maximum, bool vertical = false);
+
+      /*!
+       * @brief Set the value, it is clamped to the range of the bar.
+       * @param value The value.
+       */
+      void setValue(int32_t value);
+
+      /*!
+       * @brief Get the value.
+       */
+      int32_t value() const { return value_; }
+
+      /*!
+       * @brief Set the colors and redraw the bar.
+       * @param color The color of the filled part.
+       * @param background The color of the empty part.
+       */
+      void setColors(const Color &color, const Color &background);
+
+      void setBounds(const Rect &bounds) override;
+      bool opaque() const override { return true; }
+
+    protected:
+      void draw(Framebuffer &fb) override;
+
+    private:
+      int32_t level(int32_t value) const;
+
+      int32_t minimum_;
+      int32_t maximum_;
+      int32_t value_;
+      int32_t level_;
+      bool vertical_;
+      Color color_;
+      Color background_;
+    };
+
+    /*!
+     * @brief A bitmap, see Framebuffer::blit().
+     */
+    class Icon : public Widget
+    {
+    public:
+      /*!
+       * @brief Create an icon with the size of the bitmap.
+       * @param x The X coordinate of the top-left corner.
+       * @param y The Y coordinate of the top-left corner.
+       * @param bitmap The bitmap, its data has to outlive the icon.
+       * @param color The color of set pixels of a monochrome bitmap.
+       */
+      Icon(int32_t x, int32_t y, const Bitmap &bitmap, const Color &color = Color::white);
+
+      /*!
+       * @brief Show another bitmap, the icon takes its size.
+       * @param bitmap The bitmap, its data has to outlive the icon.
+       */
+      void setBitmap(const Bitmap &bitmap);
+
+      /*!
+       * @brief Set the color of a monochrome bitmap.
+       * @param color The color of set pixels.
+       */
+      void setColor(const Color &color);
+
+      bool opaque() const override;
+
+    protected:
+      void draw(Framebuffer &fb) override;
+
+    private:
+      Bitmap bitmap_;
+      Color color_;
+    };
+  }
+}
@@ -0,0 +1,50 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace cilo72
+{
+    namespace hw
+    {
+        /**
+         * @brief Interface of a write transfer running in the background, e.g. by DMA.
+         *
+         * The buffer passed to start() must stay valid and unchanged until busy() returns false.
+         */
+        class AsyncTransfer
+        {
+        public:
+            virtual ~AsyncTransfer() = default;
+
+            /**
+             * @brief Starts the transfer and returns immediately.
+             * @param tx The data to transmit.
+             * @param len The length of the data.
+             * @note A running transfer has to be finished before.
+             */
+            virtual void start(const uint8_t *tx, size_t len) = 0;
+
+            /**
+             * @brief Checks if the transfer is still running.
+             * @return True if the transfer is running.
+             */
+            virtual bool busy() = 0;
+
+            /**
+             * @brief Waits until the transfer is finished.
+             */
+            void wait()
+            {
+                while (busy())
+                {
+                }
+            }
+        };
+    }
+}
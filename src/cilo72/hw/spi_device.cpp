@@ -36,6 +36,17 @@ namespace cilo72
       csDeselect();
     }
 
+    void SPIDevice::select() const
+    {
+      spiBus_.config(baudrate_, data_bits_, cpol_, cpha_);
+      csSelect();
+    }
+
+    void SPIDevice::deselect() const
+    {
+      csDeselect();
+    }
+
     void SPIDevice::csSelect() const
     {
       asm volatile("nop \n nop \n nop"); // FIXME
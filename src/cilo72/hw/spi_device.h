@@ -60,6 +60,23 @@ namespace cilo72
              * @param baudrate Baudrate in Hz
              */
             void setBaudrate(uint baudrate);
+
+            /**
+             * @brief Configures the bus for this device and activates the chip select.
+             * Used for transfers not done by xfer() or write(), e.g. DMA.
+             */
+            void select() const;
+
+            /**
+             * @brief Deactivates the chip select.
+             */
+            void deselect() const;
+
+            /**
+             * @brief Gets the SPI instance of the bus.
+             * @return A pointer to the spi_inst_t struct representing the SPI instance.
+             */
+            spi_inst_t *instance() const { return spiBus_.instance(); }
         private:
             SPIBus &spiBus_;
             uint8_t pin_spi_csn_;
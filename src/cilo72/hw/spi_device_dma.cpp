@@ -0,0 +1,65 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#include "cilo72/hw/spi_device_dma.h"
+#include "hardware/dma.h"
+
+namespace cilo72
+{
+  namespace hw
+  {
+    SPIDeviceDma::SPIDeviceDma(const SPIDevice &spiDevice)
+        : spiDevice_(spiDevice), channel_(dma_claim_unused_channel(true)), active_(false)
+    {
+    }
+
+    SPIDeviceDma::~SPIDeviceDma()
+    {
+      wait();
+      dma_channel_unclaim(channel_);
+    }
+
+    void SPIDeviceDma::start(const uint8_t *tx, size_t len)
+    {
+      wait();
+
+      spi_inst_t *spi = spiDevice_.instance();
+      dma_channel_config config = dma_channel_get_default_config(channel_);
+      channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+      channel_config_set_read_increment(&config, true);
+      channel_config_set_write_increment(&config, false);
+      channel_config_set_dreq(&config, spi_get_dreq(spi, true));
+
+      spiDevice_.select();
+      active_ = true;
+      dma_channel_configure(channel_, &config, &spi_get_hw(spi)->dr, tx, len, true);
+    }
+
+    bool SPIDeviceDma::busy()
+    {
+      if (not active_)
+      {
+        return false;
+      }
+
+      spi_inst_t *spi = spiDevice_.instance();
+      if (dma_channel_is_busy(channel_) or spi_is_busy(spi))
+      {
+        return true;
+      }
+
+      // Nothing is read during the transfer, drop the received data and the overrun flag
+      while (spi_is_readable(spi))
+      {
+        (void)spi_get_hw(spi)->dr;
+      }
+      spi_get_hw(spi)->icr = SPI_SSPICR_RORIC_BITS;
+
+      spiDevice_.deselect();
+      active_ = false;
+      return false;
+    }
+  }
+}
@@ -0,0 +1,44 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "cilo72/hw/spi_device.h"
+#include "cilo72/hw/async_transfer.h"
+
+namespace cilo72
+{
+    namespace hw
+    {
+        /**
+         * @brief Writes to an SPI device by DMA.
+         *
+         * The chip select stays active from start() until the transfer is finished. The SPI bus must not be used
+         * by other devices in the meantime.
+         */
+        class SPIDeviceDma : public AsyncTransfer
+        {
+        public:
+            /**
+             * @brief Constructs an SPIDeviceDma object and claims a DMA channel.
+             * @param spiDevice The SPI device to write to.
+             */
+            SPIDeviceDma(const SPIDevice &spiDevice);
+
+            ~SPIDeviceDma();
+
+            void start(const uint8_t *tx, size_t len) override;
+
+            bool busy() override;
+
+        private:
+            const SPIDevice &spiDevice_;
+            uint channel_;
+            bool active_;
+        };
+    }
+}
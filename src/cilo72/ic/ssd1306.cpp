@@ -5,6 +5,7 @@
 
 #include "cilo72/ic/ssd1306.h"
 #include "cilo72/fonts/font.h"
+#include <assert.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -35,21 +36,60 @@ namespace cilo72
 
         constexpr uint8_t address0 = 0x3C;
         constexpr uint8_t address1 = 0x3D;
+
+        // column 127 mapped to SEG0 and scan from COM[N] to COM0 is the unrotated display, a transposed
+        // framebuffer is mirrored horizontally for 90 degrees and vertically for 270 degrees
+        uint8_t segRemap(graphic::Framebuffer::Rotation rotation)
+        {
+            return rotation == graphic::Framebuffer::Rotate0 || rotation == graphic::Framebuffer::Rotate270 ? 0x01 : 0x00;
+        }
+
+        uint8_t comOutDir(graphic::Framebuffer::Rotation rotation)
+        {
+            return rotation == graphic::Framebuffer::Rotate0 || rotation == graphic::Framebuffer::Rotate90 ? 0x08 : 0x00;
+        }
     }
 
     namespace ic
     {
-        SSD1306::SSD1306(cilo72::graphic::FramebufferMonochrome & fb, const cilo72::hw::I2CBus &i2cBus, bool useSA0)
+        SSD1306::SSD1306(cilo72::graphic::FramebufferMonochrome & fb, const cilo72::hw::I2CBus &i2cBus, bool useSA0, cilo72::graphic::Framebuffer::Rotation rotation)
             : i2cBus_(i2cBus)
             , fb_(fb)
             , external_vcc_(false)
             , address_(useSA0 ? address0 : address1)
-            , pages_(fb.height() / 8)
+            , startLine_(0)
         {
+            rotate(rotation);
             init();            
             update();
         }
 
+        bool SSD1306::setRotation(cilo72::graphic::Framebuffer::Rotation rotation)
+        {
+            // the multiplex ratio and the pages of the panel were set by init(), a transposition would change them
+            bool transposed = rotation == cilo72::graphic::Framebuffer::Rotate90 || rotation == cilo72::graphic::Framebuffer::Rotate270;
+            if (transposed != transposed_ && fb_.width() != fb_.height())
+            {
+                return false;
+            }
+
+            rotate(rotation);
+            uint8_t cmds[] = {(uint8_t)(SET_SEG_REMAP | segRemap(rotation)), (uint8_t)(SET_COM_OUT_DIR | comOutDir(rotation))};
+            write(cmds, sizeof(cmds));
+            update();
+            return true;
+        }
+
+        void SSD1306::rotate(cilo72::graphic::Framebuffer::Rotation rotation)
+        {
+            rotation_ = rotation;
+            transposed_ = rotation == cilo72::graphic::Framebuffer::Rotate90 || rotation == cilo72::graphic::Framebuffer::Rotate270;
+            width_ = transposed_ ? fb_.height() : fb_.width();
+            height_ = transposed_ ? fb_.width() : fb_.height();
+            pages_ = height_ / 8;
+            assert(width_ <= MAX_WIDTH);
+        }
+
         bool SSD1306::init()
         {
             uint8_t cmds[] = {
@@ -58,7 +98,7 @@ namespace cilo72
                 SET_DISP_CLK_DIV,
                 0x80,
                 SET_MUX_RATIO,
-                uint8_t(fb_.height() - 1),
+                uint8_t(height_ - 1),
                 SET_DISP_OFFSET,
                 0x00,
                 // resolution and layout
@@ -66,10 +106,10 @@ namespace cilo72
                 // charge pump
                 SET_CHARGE_PUMP,
                 (uint8_t)(external_vcc_ ? 0x10 : 0x14),
-                SET_SEG_REMAP | 0x01,   // column addr 127 mapped to SEG0
-                SET_COM_OUT_DIR | 0x08, // scan from COM[N] to COM0
+                (uint8_t)(SET_SEG_REMAP | segRemap(rotation_)),
+                (uint8_t)(SET_COM_OUT_DIR | comOutDir(rotation_)),
                 SET_COM_PIN_CFG,
-                (uint8_t)(fb_.width() > 2 * fb_.height() ? 0x02 : 0x12),
+                (uint8_t)(width_ > 2 * height_ ? 0x02 : 0x12),
                 // display
                 SET_CONTRAST,
                 0xff,
@@ -94,6 +134,16 @@ namespace cilo72
 
         void SSD1306::update()
         {
+            if (transposed_)
+            {
+                for (uint8_t page = 0; page < pages_; ++page)
+                {
+                    writePage(page, 0, width_);
+                }
+                fb_.clearDirty();
+                return;
+            }
+
             uint8_t payload[] = {SET_COL_ADDR, 0, (uint8_t)(fb_.width() - 1), SET_PAGE_ADDR, 0, (uint8_t)(pages_ - 1)};
             if (fb_.width() == 64)
             {
@@ -121,6 +171,67 @@ namespace cilo72
                 return index < fb_.bufferSize();
             });
 
+            fb_.clearDirty();
+        }
+
+        void SSD1306::updateDirty()
+        {
+            if (not fb_.isDirty())
+            {
+                return;
+            }
+
+            if (transposed_)
+            {
+                // the rows of the dirty region are display columns, its columns display pages
+                const cilo72::graphic::Rect dirty = fb_.dirtyRegion();
+                for (uint8_t page = dirty.x() / 8; page < (dirty.right() + 7) / 8; ++page)
+                {
+                    writePage(page, dirty.y(), dirty.bottom());
+                }
+                fb_.clearDirty();
+                return;
+            }
+
+            for (uint8_t page = 0; page < pages_; ++page)
+            {
+                if (fb_.isPageDirty(page))
+                {
+                    writePage(page, fb_.pageDirtyBegin(page), fb_.pageDirtyEnd(page));
+                }
+            }
+
+            fb_.clearDirty();
+        }
+
+        void SSD1306::writePage(uint8_t page, uint16_t begin, uint16_t end)
+        {
+            uint8_t offset = width_ == 64 ? 32 : 0;
+            uint8_t cmds[] = {SET_COL_ADDR, (uint8_t)(begin + offset), (uint8_t)(end - 1 + offset), SET_PAGE_ADDR, page, page};
+
+            write(cmds, sizeof(cmds));
+
+            uint8_t transposed[MAX_WIDTH];
+            const uint8_t *data = fb_.buffer() + page * fb_.width() + begin;
+            if (transposed_)
+            {
+                fb_.transposedPage(page, begin, end, transposed);
+                data = transposed;
+            }
+            size_t len = end - begin;
+            i2cBus_.writeBlocking(address_, [&](size_t index, uint8_t & byte) -> bool
+            {
+                if(index == 0)
+                {
+                    byte = 0x40;
+                }
+                else
+                {
+                    byte = data[index - 1];
+                }
+
+                return index < len;
+            });
         }
 
         bool SSD1306::write(uint8_t val)
@@ -129,6 +240,32 @@ namespace cilo72
             return i2cBus_.writeBlocking(address_, d, 2);
         }
 
+        bool SSD1306::write(const uint8_t *cmds, size_t len)
+        {
+            return i2cBus_.writeBlocking(address_, [&](size_t index, uint8_t & byte) -> bool
+            {
+                byte = index == 0 ? 0x00 : cmds[index - 1];
+                return index < len;
+            });
+        }
+
+        void SSD1306::setStartLine(uint8_t line)
+        {
+            startLine_ = line % height_;
+            write(SET_DISP_START_LINE | startLine_);
+        }
+
+        void SSD1306::scroll(int16_t lines)
+        {
+            int32_t line = (startLine_ + lines) % height_;
+            setStartLine(line < 0 ? line + height_ : line);
+        }
+
+        uint16_t SSD1306::scrollRow(uint16_t row) const
+        {
+            return (startLine_ + row) % height_;
+        }
+
         void SSD1306::powerOff()
         {
             write(SET_DISP | 0x00);
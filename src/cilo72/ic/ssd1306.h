@@ -27,10 +27,30 @@ namespace cilo72
       /**
        * @brief Construct a new SSD1306 object.
        *
+       * The controller mirrors columns and rows in hardware, Rotate90 and Rotate270 transpose the framebuffer
+       * 8x8 pixels at a time while transferring, see FramebufferMonochrome::transposedPage(). The framebuffer
+       * has the rotated size, e.g. 64x128 for a 128x64 display with Rotate90.
+       *
+       * @param fb The framebuffer.
        * @param i2cBus The I2C bus to use for communication with the display.
        * @param useSA0 If true, the display's SA0 pin is tied to GND.
+       * @param rotation The clockwise rotation of the framebuffer on the display.
        */
-      SSD1306(cilo72::graphic::FramebufferMonochrome & fb, const cilo72::hw::I2CBus &i2cBus, bool useSA0 = true);
+      SSD1306(cilo72::graphic::FramebufferMonochrome & fb, const cilo72::hw::I2CBus &i2cBus, bool useSA0 = true,
+              cilo72::graphic::Framebuffer::Rotation rotation = cilo72::graphic::Framebuffer::Rotate0);
+
+      /**
+       * @brief Rotate the display content and update the display.
+       * @param rotation The clockwise rotation, with the same framebuffer size as the current one, e.g. Rotate0
+       *                 and Rotate180.
+       * @return False if the rotation swaps width and height of a non-square framebuffer, nothing is changed.
+       */
+      bool setRotation(cilo72::graphic::Framebuffer::Rotation rotation);
+
+      /**
+       * @brief Returns the rotation of the framebuffer on the display.
+       */
+      cilo72::graphic::Framebuffer::Rotation rotation() const { return rotation_; }
 
       /**
        * @brief Update the display with the contents of the buffer.
@@ -38,6 +58,14 @@ namespace cilo72
        */
       void update();
 
+      /**
+       * @brief Update only the modified column range of every modified page.
+       *
+       * For each dirty page the column and page address window is set to the modified span and
+       * only these bytes are transferred. Nothing is sent if the framebuffer is not dirty.
+       */
+      void updateDirty();
+
       /**
        * @brief Turns off the display.
        */
@@ -60,6 +88,31 @@ namespace cilo72
        */
       void invert(uint8_t inv);
 
+      /**
+       * @brief Sets the RAM row shown in the first display row.
+       * @param line The start line, 0 - height - 1.
+       */
+      void setStartLine(uint8_t line);
+
+      /**
+       * @brief Scrolls the display content in hardware.
+       *
+       * The display scrolls along its rows, with Rotate90 and Rotate270 these are framebuffer columns.
+       * Only the display start line is changed, nothing is transferred. The rows scrolled in show the framebuffer
+       * rows scrolled out on the other side. Redraw only these rows, see scrollRow(), and send them with
+       * updateDirty(), which transfers the pages of the rows instead of the whole display.
+       *
+       * @param lines The number of rows, positive values move the content up.
+       */
+      void scroll(int16_t lines);
+
+      /**
+       * @brief Returns the framebuffer row shown in a display row.
+       * @param row The display row, 0 is the top row, height - 1 the bottom (newest) row.
+       * @return The framebuffer row.
+       */
+      uint16_t scrollRow(uint16_t row) const;
+
        /** 
         * @brief Returns the framebuffer of the display.
         * @return The framebuffer of the display.
@@ -67,11 +120,18 @@ namespace cilo72
       cilo72::graphic::FramebufferMonochrome & framebuffer();
       
     private:
+      static constexpr uint16_t MAX_WIDTH = 128; //< Maximum number of columns of the display.
+
       const cilo72::hw::I2CBus &i2cBus_;
       cilo72::graphic::FramebufferMonochrome & fb_;
+      cilo72::graphic::Framebuffer::Rotation rotation_;
+      bool transposed_;
       bool external_vcc_;
       uint8_t address_;
+      uint16_t width_;
+      uint16_t height_;
       uint8_t pages_;
+      uint8_t startLine_;
 
       /**
        * @brief Initializes the display.
@@ -79,12 +139,34 @@ namespace cilo72
        */
       bool init();
 
+      /**
+       * @brief Sets the rotation and the display size derived from it.
+       * @param rotation The rotation.
+       */
+      void rotate(cilo72::graphic::Framebuffer::Rotation rotation);
+
       /**
        * @brief Writes a value to the display.
        * @param val The value to write.
        * @return True if the write was successful, false otherwise.
        */
       bool write(uint8_t val);
+
+      /**
+       * @brief Writes a sequence of commands in one transfer.
+       * @param cmds The commands and their arguments.
+       * @param len The number of bytes.
+       * @return True if the write was successful, false otherwise.
+       */
+      bool write(const uint8_t *cmds, size_t len);
+
+      /**
+       * @brief Sends a part of a page, transposed from the framebuffer with Rotate90 and Rotate270.
+       * @param page The page index of the display.
+       * @param begin The first column.
+       * @param end The column after the last column.
+       */
+      void writePage(uint8_t page, uint16_t begin, uint16_t end);
     };
   }
 }
@@ -3,6 +3,8 @@
   SPDX-License-Identifier: MIT-0
 */
 
+#include <assert.h>
+#include <utility>
 #include "cilo72/ic/st7735s.h"
 
 namespace cilo72
@@ -10,7 +12,22 @@ namespace cilo72
     namespace ic
     {
         ST7735S::ST7735S(cilo72::graphic::FramebufferRGB565 & fb, cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL)
-            : fb_(fb), spi_(spi), pinDC_(pinDC, cilo72::hw::Gpio::Direction::Output, cilo72::hw::Gpio::Level::Low), pinRST_(pinRST, cilo72::hw::Gpio::Direction::Output, cilo72::hw::Gpio::Level::High), pinBL_(pinBL), scanDirection_(ScanDirection::Horizontal), swap_(false)
+            : ST7735S(&fb, nullptr, spi, pinDC, pinRST, pinBL)
+        {
+        }
+
+        ST7735S::ST7735S(cilo72::graphic::FramebufferIndexed & fb, cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL)
+            : ST7735S(nullptr, &fb, spi, pinDC, pinRST, pinBL)
+        {
+        }
+
+        ST7735S::ST7735S(cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL)
+            : ST7735S(nullptr, nullptr, spi, pinDC, pinRST, pinBL)
+        {
+        }
+
+        ST7735S::ST7735S(cilo72::graphic::FramebufferRGB565 *fb, cilo72::graphic::FramebufferIndexed *indexed, cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL)
+            : fb_(fb), front_(nullptr), indexed_(indexed), transfer_(nullptr), spi_(spi), pinDC_(pinDC, cilo72::hw::Gpio::Direction::Output, cilo72::hw::Gpio::Level::Low), pinRST_(pinRST, cilo72::hw::Gpio::Direction::Output, cilo72::hw::Gpio::Level::High), pinBL_(pinBL), scanDirection_(ScanDirection::Horizontal), rotation_(cilo72::graphic::Framebuffer::Rotate0), scrollFirst_(0), scrollCount_(0), scrollOffset_(0), swap_(false)
         {
             union 
             {
@@ -22,7 +39,14 @@ namespace cilo72
             tx[1] = 0xAA;
 
             swap_ = data == 0xAA55;
-            fb.setSwapBytes(swap_);
+            if (fb_ != nullptr)
+            {
+                fb_->setSwapBytes(swap_);
+            }
+            else if (indexed_ != nullptr)
+            {
+                indexed_->setSwapBytes(swap_);
+            }
             
             spi_.setBaudrate(10000000);
             spi_.setFormat(8, SPI_CPOL_0, SPI_CPHA_0);
@@ -40,7 +64,7 @@ namespace cilo72
         {
             reset();
 
-            cmdMemoryDataAccessControl(false, true, true, true, true, false);
+            cmdMemoryDataAccessControl(rotation_);
             cmdInterfacePixelFormat(ColorMode::RGB565);
             cmdFrameRateControlNormalMode(0x01, 0x2C, 0x2D); // Frame Rate = 95Hz
             cmdFrameRateControlIdleMode(0x01, 0x2C, 0x2D); // Frame Rate = 95Hz
@@ -58,6 +82,14 @@ namespace cilo72
             cmdDisplayOn();            
         }
 
+        void ST7735S::setRotation(cilo72::graphic::Framebuffer::Rotation rotation)
+        {
+            rotation_ = rotation;
+            bool transposed = rotation == cilo72::graphic::Framebuffer::Rotate90 || rotation == cilo72::graphic::Framebuffer::Rotate270;
+            scanDirection_ = transposed ? ScanDirection::Vertical : ScanDirection::Horizontal;
+            cmdMemoryDataAccessControl(rotation_);
+        }
+
         void ST7735S::clear(const cilo72::graphic::Color &Color) const
         {
             uint16_t data = Color.toRGB565(Color, swap_);
@@ -69,20 +101,284 @@ namespace cilo72
 
             PixelData pixelData = { .data = data };
 
-            cmdAaddressSet(0, 0, MAX_WIDTH, MAX_HEIGHT);
+            if (scanDirection_ == ScanDirection::Horizontal)
+            {
+                cmdAaddressSet(0, 0, MAX_WIDTH, MAX_HEIGHT);
+            }
+            else
+            {
+                cmdAaddressSet(0, 0, MAX_HEIGHT, MAX_WIDTH);
+            }
 
             cmd(CMD_RAMWR, nullptr, 0);
             pinDC_.set();
             spi_.write(pixelData.tx, sizeof(pixelData.tx), MAX_WIDTH * MAX_HEIGHT * 2);
         }
 
+        bool ST7735S::drawImage(cilo72::graphic::QoiDecoder &image, uint16_t x, uint16_t y) const
+        {
+            if (not image.valid())
+            {
+                return false;
+            }
+
+            image.rewind();
+            cmdAaddressSet(x, y, x + image.width(), y + image.height());
+            cmd(CMD_RAMWR, nullptr, 0);
+            pinDC_.set();
+
+            uint8_t chunks[2][CHUNK_PIXELS * 2];
+            uint8_t current = 0;
+            uint32_t pixels = 0;
+            while (image.remaining() > 0)
+            {
+                size_t count = image.read(chunks[current], CHUNK_PIXELS);
+                if (count == 0)
+                {
+                    break;
+                }
+
+                if (transfer_ != nullptr)
+                {
+                    transfer_->wait();
+                    transfer_->start(chunks[current], count * 2);
+                }
+                else
+                {
+                    spi_.write(chunks[current], count * 2);
+                }
+                current ^= 1;
+                pixels += count;
+            }
+            waitFlush();
+
+            // the rest of the window keeps its content if the image is truncated
+            return pixels == (uint32_t)image.width() * image.height();
+        }
+
         void ST7735S::update() const
         {
-            cmdAaddressSet(0, 0, fb_.width(), fb_.height());
+            if (fb_ == nullptr && indexed_ == nullptr)
+            {
+                return;
+            }
+
+            cilo72::graphic::Framebuffer &fb = target();
+            writeWindow(cilo72::graphic::Rect(0, 0, fb.width(), fb.height()), 0);
+            fb.clearDirty();
+        }
+
+        void ST7735S::updateDirty() const
+        {
+            if (fb_ == nullptr && indexed_ == nullptr)
+            {
+                return;
+            }
+
+            cilo72::graphic::Framebuffer &fb = target();
+            const cilo72::graphic::Rect dirty = fb.dirtyRegion();
+            if (dirty.isEmpty())
+            {
+                return;
+            }
+
+            writeWindow(dirty, dirty.y());
+            fb.clearDirty();
+        }
+
+        void ST7735S::updateBands(const cilo72::graphic::DisplayList &list, uint16_t height, const cilo72::graphic::Color &background)
+        {
+            if (fb_ == nullptr && indexed_ == nullptr)
+            {
+                return;
+            }
+
+            for (uint16_t y = 0; y < height; y += target().height())
+            {
+                cilo72::graphic::Framebuffer &fb = target();
+                uint16_t rows = height - y < fb.height() ? height - y : fb.height();
+
+                // the buffer still holds a previous band
+                fb.clear(background);
+                list.replay(fb, 0, -y);
+
+                if (front_ != nullptr)
+                {
+                    startFlush(*fb_, y, rows);
+                    std::swap(fb_, front_);
+                }
+                else
+                {
+                    writeWindow(cilo72::graphic::Rect(0, 0, fb.width(), rows), y);
+                }
+                fb.clearDirty();
+            }
+        }
+
+        void ST7735S::setDoubleBuffer(cilo72::graphic::FramebufferRGB565 &second, cilo72::hw::AsyncTransfer &transfer)
+        {
+            assert(fb_ != nullptr && second.width() == fb_->width() && second.height() == fb_->height());
+
+            waitFlush();
+            second.setSwapBytes(swap_);
+            front_ = &second;
+            transfer_ = &transfer;
+        }
+
+        void ST7735S::setTransfer(cilo72::hw::AsyncTransfer &transfer)
+        {
+            waitFlush();
+            transfer_ = &transfer;
+        }
+
+        void ST7735S::swap()
+        {
+            if (front_ == nullptr)
+            {
+                update();
+                return;
+            }
+
+            startFlush(*fb_, 0, fb_->height());
+            fb_->clearDirty();
+            std::swap(fb_, front_);
+        }
+
+        bool ST7735S::flushing() const
+        {
+            return transfer_ != nullptr && transfer_->busy();
+        }
 
+        void ST7735S::waitFlush() const
+        {
+            if (transfer_ != nullptr)
+            {
+                transfer_->wait();
+            }
+        }
+
+        void ST7735S::setScrollArea(uint16_t first, uint16_t count)
+        {
+            scrollFirst_ = first;
+            scrollCount_ = count;
+            scrollOffset_ = 0;
+            uint16_t tfa = scrollTop();
+            cmdVerticalScrollDefinition(tfa, count, GATE_LINES - tfa - count);
+            cmdVerticalScrollStartAddress(tfa);
+        }
+
+        void ST7735S::scroll(int16_t lines)
+        {
+            if (scrollCount_ == 0)
+            {
+                return;
+            }
+
+            int32_t offset = (scrollOffset_ + lines) % scrollCount_;
+            scrollOffset_ = offset < 0 ? offset + scrollCount_ : offset;
+
+            // with MY the framebuffer lines are written to the gate lines in reverse order, so they scroll the other way
+            uint16_t start = mirrored() ? (scrollCount_ - scrollOffset_) % scrollCount_ : scrollOffset_;
+            cmdVerticalScrollStartAddress(scrollTop() + start);
+        }
+
+        bool ST7735S::mirrored() const
+        {
+            return rotation_ == cilo72::graphic::Framebuffer::Rotate90 || rotation_ == cilo72::graphic::Framebuffer::Rotate180;
+        }
+
+        uint16_t ST7735S::scrollTop() const
+        {
+            // the first and the last gate line are not visible, like the address offset in cmdAaddressSet()
+            return mirrored() ? GATE_LINES - 1 - scrollFirst_ - scrollCount_ : scrollFirst_ + 1;
+        }
+
+        uint16_t ST7735S::scrollLine(uint16_t line) const
+        {
+            if (scrollCount_ == 0)
+            {
+                return line;
+            }
+            return scrollFirst_ + (scrollOffset_ + line) % scrollCount_;
+        }
+
+        cilo72::graphic::Framebuffer &ST7735S::target() const
+        {
+            if (fb_ != nullptr)
+            {
+                return *fb_;
+            }
+            return *indexed_;
+        }
+
+        void ST7735S::writeWindow(const cilo72::graphic::Rect &rect, uint16_t y) const
+        {
+            cmdAaddressSet(rect.x(), y, rect.right(), y + rect.height());
+
+            cmd(CMD_RAMWR, nullptr, 0);
+            pinDC_.set();
+
+            if (indexed_ != nullptr)
+            {
+                writeIndexed(rect);
+                return;
+            }
+
+            const uint8_t *row = fb_->buffer() + (rect.y() * fb_->width() + rect.x()) * 2;
+            if (rect.width() == fb_->width())
+            {
+                spi_.write(row, rect.width() * rect.height() * 2);
+            }
+            else
+            {
+                for (int16_t i = 0; i < rect.height(); ++i, row += fb_->width() * 2)
+                {
+                    spi_.write(row, rect.width() * 2);
+                }
+            }
+        }
+
+        void ST7735S::writeIndexed(const cilo72::graphic::Rect &rect) const
+        {
+            uint16_t chunks[2][CHUNK_PIXELS];
+            uint8_t current = 0;
+            uint16_t count = 0;
+
+            for (int32_t y = rect.y(); y < rect.bottom(); ++y)
+            {
+                for (int32_t x = rect.x(); x < rect.right();)
+                {
+                    uint16_t n = rect.right() - x < CHUNK_PIXELS - count ? rect.right() - x : CHUNK_PIXELS - count;
+                    indexed_->toRGB565(x, y, n, chunks[current] + count);
+                    x += n;
+                    count += n;
+
+                    bool last = y == rect.bottom() - 1 && x == rect.right();
+                    if (count == CHUNK_PIXELS || last)
+                    {
+                        if (transfer_ != nullptr)
+                        {
+                            transfer_->wait();
+                            transfer_->start(reinterpret_cast<const uint8_t *>(chunks[current]), count * 2);
+                        }
+                        else
+                        {
+                            spi_.write(reinterpret_cast<const uint8_t *>(chunks[current]), count * 2);
+                        }
+                        current ^= 1;
+                        count = 0;
+                    }
+                }
+            }
+            waitFlush();
+        }
+
+        void ST7735S::startFlush(const cilo72::graphic::FramebufferRGB565 &fb, uint16_t y, uint16_t rows) const
+        {
+            cmdAaddressSet(0, y, fb.width(), y + rows);
             cmd(CMD_RAMWR, nullptr, 0);
             pinDC_.set();
-            spi_.write(fb_.buffer(), fb_.bufferSize());
+            transfer_->start(fb.buffer(), fb.width() * rows * 2);
         }
 
         void ST7735S::cmdAaddressSet(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) const
@@ -117,6 +413,7 @@ namespace cilo72
             uint8_t txCmd[1] = {0};
             txCmd[0] = cmd;
 
+            waitFlush();
             pinDC_.clear();
             spi_.write(txCmd, sizeof(txCmd));
             if(tx != nullptr && len > 0)
@@ -150,6 +447,30 @@ namespace cilo72
             cmd(CMD_RASET, tx, sizeof(tx));
         }
 
+        void ST7735S::cmdVerticalScrollDefinition(uint16_t tfa, uint16_t vsa, uint16_t bfa) const
+        {
+            uint8_t tx[6] = {0};
+
+            tx[0] = (tfa >> 8) & 0xFF;
+            tx[1] = (tfa >> 0) & 0xFF;
+            tx[2] = (vsa >> 8) & 0xFF;
+            tx[3] = (vsa >> 0) & 0xFF;
+            tx[4] = (bfa >> 8) & 0xFF;
+            tx[5] = (bfa >> 0) & 0xFF;
+
+            cmd(CMD_VSCRDEF, tx, sizeof(tx));
+        }
+
+        void ST7735S::cmdVerticalScrollStartAddress(uint16_t ssa) const
+        {
+            uint8_t tx[2] = {0};
+
+            tx[0] = (ssa >> 8) & 0xFF;
+            tx[1] = (ssa >> 0) & 0xFF;
+
+            cmd(CMD_VSCRSADD, tx, sizeof(tx));
+        }
+
         void ST7735S::cmdDisplayOn() const
         {
             cmd(CMD_DISPON, nullptr, 0);
@@ -327,6 +648,26 @@ namespace cilo72
             cmd(CMD_GMCTRN1, tx, sizeof(tx));
         }
 
+        void ST7735S::cmdMemoryDataAccessControl(cilo72::graphic::Framebuffer::Rotation rotation) const
+        {
+            // Rotate0 is landscape with MX and MV, every further 90 degrees clockwise follow the MADCTL rotation cycle
+            switch (rotation)
+            {
+            case cilo72::graphic::Framebuffer::Rotate90:
+                cmdMemoryDataAccessControl(true, true, false, true, true, false);
+                break;
+            case cilo72::graphic::Framebuffer::Rotate180:
+                cmdMemoryDataAccessControl(true, false, true, true, true, false);
+                break;
+            case cilo72::graphic::Framebuffer::Rotate270:
+                cmdMemoryDataAccessControl(false, false, false, true, true, false);
+                break;
+            default:
+                cmdMemoryDataAccessControl(false, true, true, true, true, false);
+                break;
+            }
+        }
+
         void ST7735S::cmdMemoryDataAccessControl(bool my, bool mx, bool mv, bool ml, bool rgb, bool mh) const
         {
             uint8_t tx[1] = {0};
@@ -10,7 +10,11 @@
 #include "cilo72/hw/spi_device.h"
 #include "cilo72/hw/gpio.h"
 #include "cilo72/hw/pwm.h"
+#include "cilo72/hw/async_transfer.h"
 #include "cilo72/graphic/framebuffer_rgb565.h"
+#include "cilo72/graphic/framebuffer_indexed.h"
+#include "cilo72/graphic/display_list.h"
+#include "cilo72/graphic/qoi_decoder.h"
 
 namespace cilo72
 {
@@ -25,6 +29,8 @@ namespace cilo72
         public:
             static constexpr uint32_t MAX_WIDTH = 162; //<Maximum width 162 Pixel
             static constexpr uint32_t MAX_HEIGHT = 132; //<Maximum height 132 Pixel
+            static constexpr uint16_t CHUNK_PIXELS = 64; //<Pixels per conversion chunk of an indexed framebuffer
+            static constexpr uint16_t GATE_LINES = 162; //<Lines of the frame memory along the scroll direction
 
             /*!
              * @brief Constructor
@@ -36,6 +42,33 @@ namespace cilo72
              */
             ST7735S(cilo72::graphic::FramebufferRGB565 &fb, cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL);
 
+            /*!
+             * @brief Constructor with a palette framebuffer
+             *
+             * The pixels are converted to RGB565 while they are transferred, CHUNK_PIXELS at a time.
+             * Double buffering is not available, framebuffer() must not be used.
+             *
+             * @param fb Framebuffer
+             * @param spi SPI device
+             * @param pinDC Pin DC
+             * @param pinRST Pin RST
+             * @param pinBL Pin BL
+             */
+            ST7735S(cilo72::graphic::FramebufferIndexed &fb, cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL);
+
+            /*!
+             * @brief Constructor without framebuffer
+             *
+             * Only clear() and drawImage() write to the display, e.g. for a splash screen. update() and the other
+             * framebuffer functions do nothing, framebuffer() must not be used.
+             *
+             * @param spi SPI device
+             * @param pinDC Pin DC
+             * @param pinRST Pin RST
+             * @param pinBL Pin BL
+             */
+            ST7735S(cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL);
+
             /*!
              * @brief Reset display
              */
@@ -44,6 +77,23 @@ namespace cilo72
             * @brief Initialize display
             */
             void init() const;
+
+            /*!
+             * @brief Rotate the display content
+             *
+             * The controller rotates in hardware with the MV, MX and MY bits of MADCTL, the framebuffer is
+             * transferred unchanged. With Rotate90 and Rotate270 the framebuffer is 128x160 instead of 160x128.
+             * The display content is not redrawn, call update() afterwards.
+             *
+             * @param rotation Clockwise rotation of the framebuffer on the display, init() uses Rotate0
+             */
+            void setRotation(cilo72::graphic::Framebuffer::Rotation rotation);
+
+            /*!
+             * @brief Get the rotation of the framebuffer on the display
+             * @return Rotation
+             */
+            cilo72::graphic::Framebuffer::Rotation rotation() const { return rotation_; }
             
             /*!
              * @brief Clear display and fill with given color
@@ -51,16 +101,122 @@ namespace cilo72
              */
             void clear(const cilo72::graphic::Color &color) const;
 
+            /*!
+             * @brief Decode an image directly into a window of the display
+             *
+             * The image is decoded CHUNK_PIXELS at a time into a buffer on the stack and sent to the address
+             * window of the image, the framebuffer is not used. With setTransfer(), the next chunk is decoded
+             * while the previous one is transferred.
+             *
+             * @param image The image, decoded from the first pixel
+             * @param x X coordinate of the top-left corner
+             * @param y Y coordinate of the top-left corner
+             * @return False if the image is not valid or truncated
+             * @note The image must fit into the display.
+             */
+            bool drawImage(cilo72::graphic::QoiDecoder &image, uint16_t x, uint16_t y) const;
+
             /*!
              * @brief Update display
              */
             void update() const;
 
+            /*!
+             * @brief Update only the dirty region of the framebuffer
+             *
+             * The address window is set to the bounding rectangle of all pixels modified since the
+             * last update and only the rows of this window are transferred. Nothing is sent if the
+             * framebuffer is not dirty.
+             */
+            void updateDirty() const;
+
+            /*!
+             * @brief Render a display list band by band and update the display
+             *
+             * The framebuffer of the driver is used as band buffer, e.g. 160 * 16 pixel instead of 160 * 128.
+             * For each band the buffer is cleared with the background, the display list is replayed into it,
+             * shifted by the band position, and the band is transferred to its rows of the display.
+             *
+             * @param list The display list with the drawing commands of the screen
+             * @param height The height of the screen in pixel
+             * @param background Color of the pixels the display list does not draw
+             */
+            void updateBands(const cilo72::graphic::DisplayList &list, uint16_t height, const cilo72::graphic::Color &background = cilo72::graphic::Color(0, 0, 0));
+
+            /*!
+             * @brief Enable double buffering
+             *
+             * The framebuffer passed to the constructor and the second one are used alternately. While one is
+             * transferred in the background by swap(), the application draws into the other one.
+             * In band mode, rendering the next band overlaps with the transfer of the previous one.
+             *
+             * @param second Second framebuffer, same size as the first one
+             * @param transfer Background transfer to the SPI device of the display, e.g. cilo72::hw::SPIDeviceDma
+             * @warning Only available with an RGB565 framebuffer, otherwise or with a different size this results in an assert!
+             */
+            void setDoubleBuffer(cilo72::graphic::FramebufferRGB565 &second, cilo72::hw::AsyncTransfer &transfer);
+
+            /*!
+             * @brief Transfer the conversion chunks of a palette framebuffer in the background
+             *
+             * While a chunk is transferred, the next one is converted, so the SPI does not wait for the conversion.
+             *
+             * @param transfer Background transfer to the SPI device of the display, e.g. cilo72::hw::SPIDeviceDma
+             */
+            void setTransfer(cilo72::hw::AsyncTransfer &transfer);
+
+            /*!
+             * @brief Start the transfer of the framebuffer and switch to the other one
+             *
+             * Waits only if the previous transfer is still running. After the call, framebuffer() returns the
+             * other buffer, which still contains the frame before the one being transferred.
+             * Without double buffering, this is the same as update().
+             */
+            void swap();
+
+            /*!
+             * @brief Check if a framebuffer is being transferred in the background
+             * @return True while the transfer is running
+             */
+            bool flushing() const;
+
+            /*!
+             * @brief Wait until the background transfer is finished
+             */
+            void waitFlush() const;
+
+            /*!
+             * @brief Define the hardware scroll area
+             *
+             * The ST7735S scrolls along its gate lines. With Rotate0 and Rotate180 these are the columns of the
+             * framebuffer, so the content moves horizontally, e.g. for a strip chart, with Rotate90 and Rotate270
+             * the rows. Lines outside the area are fixed. Set the rotation first.
+             *
+             * @param first First framebuffer line of the scroll area
+             * @param count Number of lines of the scroll area
+             */
+            void setScrollArea(uint16_t first, uint16_t count);
+            /*!
+             * @brief Scroll the content of the scroll area in hardware
+             *
+             * Only the start address of the display is changed, nothing is transferred. The lines scrolled in
+             * show the framebuffer lines scrolled out on the other side. Redraw only these lines, see scrollLine(),
+             * and send them with updateDirty().
+             *
+             * @param lines Number of lines, positive values move the content towards the first line
+             */
+            void scroll(int16_t lines);
+            /*!
+             * @brief Get the framebuffer line shown at a line of the scroll area
+             * @param line Line of the scroll area, 0 is the first line, count - 1 the last (newest) one
+             * @return Framebuffer line
+             */
+            uint16_t scrollLine(uint16_t line) const;
             /*!
              * @brief Get framebuffer
              * @return Framebuffer
              */
-            cilo72::graphic::FramebufferRGB565 & framebuffer() const { return fb_;}
+            cilo72::graphic::FramebufferRGB565 & framebuffer() const { return *fb_;}
 
             /*!
              * @brief Set backlight level
@@ -83,6 +239,8 @@ namespace cilo72
                 CMD_CASET = 0x2A,
                 CMD_RASET = 0x2B,
                 CMD_RAMWR = 0x2C,
+                CMD_VSCRDEF = 0x33,
+                CMD_VSCRSADD = 0x37,
                 CMD_MADCTL = 0x36,
                 CMD_COLMOD = 0x3A,
                 CMD_FRMCTR1 = 0xB1,
@@ -106,16 +264,33 @@ namespace cilo72
                 RGB666 = 0x06,
             };
 
-            cilo72::graphic::FramebufferRGB565 &fb_;
+            cilo72::graphic::FramebufferRGB565 *fb_;
+            cilo72::graphic::FramebufferRGB565 *front_;
+            cilo72::graphic::FramebufferIndexed *indexed_;
+            cilo72::hw::AsyncTransfer *transfer_;
             cilo72::hw::SPIDevice &spi_;
             cilo72::hw::Gpio pinDC_;
             cilo72::hw::Gpio pinRST_;
             cilo72::hw::Pwm pinBL_;
             ScanDirection scanDirection_;
+            cilo72::graphic::Framebuffer::Rotation rotation_;
+            uint16_t scrollFirst_;
+            uint16_t scrollCount_;
+            uint16_t scrollOffset_;
             bool swap_;
 
             void cmd(CMD cmd, const uint8_t *tx, size_t len) const;
+            ST7735S(cilo72::graphic::FramebufferRGB565 *fb, cilo72::graphic::FramebufferIndexed *indexed, cilo72::hw::SPIDevice &spi, uint8_t pinDC, uint8_t pinRST, uint8_t pinBL);
+
+            cilo72::graphic::Framebuffer &target() const;
+            void startFlush(const cilo72::graphic::FramebufferRGB565 &fb, uint16_t y, uint16_t rows) const;
+            void writeWindow(const cilo72::graphic::Rect &rect, uint16_t y) const;
+            void writeIndexed(const cilo72::graphic::Rect &rect) const;
+
+            bool mirrored() const;
+            uint16_t scrollTop() const;
 
+            void cmdMemoryDataAccessControl(cilo72::graphic::Framebuffer::Rotation rotation) const;
             void cmdMemoryDataAccessControl(bool my, bool mx, bool mv, bool ml, bool rgb, bool mh) const;
             void cmdColumnAddressSet(uint16_t xStart, uint16_t xEnd) const;
             void cmdRowAddressSet(uint16_t xStart, uint16_t xEnd) const;
@@ -136,6 +311,8 @@ namespace cilo72
             void cmdGammaPlusPolarityCorrection(uint8_t vrf0p, uint8_t vos0p, uint8_t pk0p, uint8_t pk1p, uint8_t pk2p, uint8_t pk3p, uint8_t pk4p, uint8_t pk5p, uint8_t pk6p, uint8_t pk7p, uint8_t pk8p, uint8_t pk9p, uint8_t selv0p, uint8_t selv1p, uint8_t selv62p, uint8_t selv63p) const;
             void cmdGammaMinusPolarityCorrection(uint8_t vrf0n, uint8_t vos0n, uint8_t pk0n, uint8_t pk1n, uint8_t pk2n, uint8_t pk3n, uint8_t pk4n, uint8_t pk5n, uint8_t pk6n, uint8_t pk7n, uint8_t pk8n, uint8_t pk9n, uint8_t selv0n, uint8_t selv1n, uint8_t selv62n, uint8_t selv63n) const;
             void cmdAaddressSet(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) const;
+            void cmdVerticalScrollDefinition(uint16_t tfa, uint16_t vsa, uint16_t bfa) const;
+            void cmdVerticalScrollStartAddress(uint16_t ssa) const;
         };
     }
 }
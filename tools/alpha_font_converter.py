@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Daniel Zwirner
+# SPDX-License-Identifier: MIT-0
+#
+# Render a TrueType font to a C++ header with a cilo72::fonts::AlphaFont for Framebuffer::drawString().
+#
+#   tools/alpha_font_converter.py DejaVuSansMono.ttf 12 mono12 -o src/assets/mono12.h
+#
+# Every glyph is rendered antialiased into a cell of the widest advance and the height of the font, one byte
+# of coverage per pixel (see src/cilo72/fonts/alpha_font.h). Monospaced fonts give the best result.
+
+import argparse
+import sys
+
+from PIL import Image, ImageDraw, ImageFont
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Render a TrueType font to a cilo72::fonts::AlphaFont header')
+    parser.add_argument('font', help='TrueType or OpenType font file')
+    parser.add_argument('size', type=int, help='size in pixels')
+    parser.add_argument('name', help='name of the C++ constant')
+    parser.add_argument('--first', type=int, default=32, help='first character (default 32)')
+    parser.add_argument('--last', type=int, default=126, help='last character (default 126)')
+    parser.add_argument('-s', '--spacing', type=int, default=0, help='spacing between characters (default 0)')
+    parser.add_argument('-n', '--namespace', default='assets', help='C++ namespace (default assets)')
+    parser.add_argument('-o', '--output', help='output header, default stdout')
+    args = parser.parse_args()
+
+    font = ImageFont.truetype(args.font, args.size)
+    ascent, descent = font.getmetrics()
+    chars = [chr(c) for c in range(args.first, args.last + 1)]
+    width = max(int(round(font.getlength(c))) for c in chars)
+    height = ascent + descent
+
+    data = bytearray()
+    for c in chars:
+        image = Image.new('L', (width, height), 0)
+        ImageDraw.Draw(image).text((0, 0), c, font=font, fill=255)
+        data += bytes(image.getdata())
+
+    lines = []
+    for i in range(0, len(data), width):
+        lines.append('        ' + ', '.join('0x%02X' % b for b in data[i:i + width]) + ',')
+
+    out = []
+    out.append('/*')
+    out.append('  Generated by tools/alpha_font_converter.py from %s, %d px, %dx%d, %d bytes'
+               % (args.font, args.size, width, height, len(data)))
+    out.append('*/')
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('#include <stdint.h>')
+    out.append('#include "cilo72/fonts/alpha_font.h"')
+    out.append('')
+    out.append('namespace %s' % args.namespace)
+    out.append('{')
+    out.append('    inline constexpr uint8_t %s_data[] = {' % args.name)
+    out.extend(lines)
+    out.append('    };')
+    out.append('')
+    out.append('    inline constexpr cilo72::fonts::AlphaFont %s(%d, %d, %d, %d, %d, %s_data);'
+               % (args.name, width, height, args.spacing, args.first, args.last, args.name))
+    out.append('}')
+    out.append('')
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write('\n'.join(out))
+    else:
+        sys.stdout.write('\n'.join(out))
+
+    print('%s: %dx%d, %d glyphs, %d bytes' % (args.name, width, height, len(chars), len(data)), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,85 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host micro benchmark of BasicFramebuffer against FramebufferRGB565: both redraw the same text heavy 160x128
+  screen, 16 lines of status text with a few separators. BasicFramebuffer inlines the pixel operations into the
+  drawing code, FramebufferRGB565 calls them through the virtual hooks. The tool prints the speedup and exits
+  with 1 if the two framebuffers hold different pixels.
+
+    g++ -std=c++17 -O2 -I src tools/basic_framebuffer_benchmark.cpp src/cilo72/graphic/framebuffer.cpp \
+        src/cilo72/graphic/framebuffer_rgb565.cpp src/cilo72/graphic/glyph_cache.cpp \
+        src/cilo72/fonts/font_8x5.cpp -o basic_framebuffer_benchmark && ./basic_framebuffer_benchmark
+
+  The absolute numbers are host numbers, the Cortex-M0+ pays more for an indirect call per pixel or span.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "cilo72/graphic/framebuffer_rgb565.h"
+#include "cilo72/graphic/basic_framebuffer.h"
+
+using cilo72::graphic::BasicFramebuffer;
+using cilo72::graphic::Color;
+using cilo72::graphic::FramebufferRGB565;
+using cilo72::graphic::PixelFormatRGB565;
+
+namespace
+{
+  constexpr uint16_t WIDTH = 160;
+  constexpr uint16_t HEIGHT = 128;
+  constexpr int ROUNDS = 500;
+
+  // the same calls for both, so the framebuffer type decides between inlined and virtual pixel operations
+  template <class FB>
+  void screen(FB &fb, int frame)
+  {
+    static const char *const labels[] = {"temp", "hum", "press", "wind", "rain", "batt", "rssi", "uptime"};
+    char text[32];
+
+    fb.clear(Color(0, 0, 32));
+    for (int line = 0; line < 16; ++line)
+    {
+      int32_t y = line * 8;
+      snprintf(text, sizeof(text), "%-6s %5d.%d %s", labels[line % 8], (frame * 7 + line * 13) % 1000, line, line & 1 ? "ok" : "--");
+      fb.drawString(2, y, 1, text, line & 1 ? Color::white : Color(255, 200, 0));
+      if (line % 4 == 3)
+      {
+        fb.drawLine(0, y + 7, WIDTH - 1, y + 7, Color(0, 128, 255));
+      }
+    }
+  }
+
+  template <class FB>
+  double measure(FB &fb)
+  {
+    double best = 1e30;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+      auto start = std::chrono::steady_clock::now();
+      screen(fb, round);
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      best = us < best ? us : best;
+    }
+    return best;
+  }
+}
+
+int main()
+{
+  FramebufferRGB565 dynamic(WIDTH, HEIGHT);
+  static BasicFramebuffer<PixelFormatRGB565, WIDTH, HEIGHT> inlined;
+
+  double virtualCalls = measure(dynamic);
+  double inlinedCalls = measure(inlined);
+
+  // both ended with the screen of the last round
+  bool same = memcmp(dynamic.buffer(), inlined.buffer(), dynamic.bufferSize()) == 0;
+
+  printf("FramebufferRGB565                         %8.2f us/screen\n", virtualCalls);
+  printf("BasicFramebuffer<PixelFormatRGB565, ...>  %8.2f us/screen   %.2fx%s\n", inlinedCalls,
+         virtualCalls / inlinedCalls, same ? "" : "   MISMATCH");
+  return same ? 0 : 1;
+}
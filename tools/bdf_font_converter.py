@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Daniel Zwirner
+# SPDX-License-Identifier: MIT-0
+#
+# Convert a BDF bitmap font to a C++ header with a cilo72::fonts::ProportionalFont.
+#
+#   tools/bdf_font_converter.py helvR12.bdf helv12 -c -o src/assets/helv12.h
+#
+# The glyphs are stored column by column, (height + 7) / 8 bytes per column with the top row in the least
+# significant bit, trimmed to the columns with set pixels (see src/cilo72/fonts/proportional_font.h).
+# With --compress every glyph is run length encoded on its own.
+
+import argparse
+import sys
+
+
+def parse_bdf(path):
+    font = {'glyphs': {}}
+    glyph = None
+    bitmap = None
+    with open(path) as f:
+        for line in f:
+            words = line.split()
+            if not words:
+                continue
+            key = words[0]
+            if bitmap is not None:
+                if key == 'ENDCHAR':
+                    glyph['bitmap'] = bitmap
+                    if glyph.get('encoding', -1) >= 0:
+                        font['glyphs'][glyph['encoding']] = glyph
+                    glyph = None
+                    bitmap = None
+                else:
+                    bitmap.append(words[0])
+            elif key == 'FONTBOUNDINGBOX':
+                font['bbx'] = [int(v) for v in words[1:5]]
+            elif key == 'FONT_ASCENT':
+                font['ascent'] = int(words[1])
+            elif key == 'FONT_DESCENT':
+                font['descent'] = int(words[1])
+            elif key == 'STARTCHAR':
+                glyph = {}
+            elif glyph is not None and key == 'ENCODING':
+                glyph['encoding'] = int(words[1])
+            elif glyph is not None and key == 'DWIDTH':
+                glyph['advance'] = int(words[1])
+            elif glyph is not None and key == 'BBX':
+                glyph['bbx'] = [int(v) for v in words[1:5]]
+            elif glyph is not None and key == 'BITMAP':
+                bitmap = []
+
+    if 'ascent' not in font:
+        font['ascent'] = font['bbx'][1] + font['bbx'][3]
+    if 'descent' not in font:
+        font['descent'] = -font['bbx'][3]
+    return font
+
+
+def glyph_pixels(font, glyph):
+    """Set pixels of a glyph as (x, y), x relative to the pen position, y relative to the top of the cell."""
+    width, height, xoff, yoff = glyph['bbx']
+    top = font['ascent'] - yoff - height
+    pixels = set()
+    for r, row in enumerate(glyph['bitmap'][:height]):
+        bits = int(row, 16)
+        count = len(row) * 4
+        for c in range(width):
+            if bits >> (count - 1 - c) & 1:
+                pixels.add((xoff + c, top + r))
+    return pixels
+
+
+def encode_rle(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out += bytes((0x80 | (run - 1), data[i]))
+            i += run
+            continue
+
+        start = i
+        while i < len(data) and i - start < 128:
+            if i + 1 < len(data) and data[i + 1] == data[i]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a BDF font to a cilo72::fonts::ProportionalFont header')
+    parser.add_argument('bdf', help='BDF font file')
+    parser.add_argument('name', help='name of the C++ constant')
+    parser.add_argument('--first', type=int, default=32, help='first character (default 32)')
+    parser.add_argument('--last', type=int, default=126, help='last character (default 126)')
+    parser.add_argument('-s', '--spacing', type=int, default=0, help='additional spacing added to every advance')
+    parser.add_argument('-c', '--compress', action='store_true', help='run length encode the glyphs')
+    parser.add_argument('-n', '--namespace', default='assets', help='C++ namespace (default assets)')
+    parser.add_argument('-o', '--output', help='output header, default stdout')
+    args = parser.parse_args()
+
+    font = parse_bdf(args.bdf)
+    height = font['ascent'] + font['descent']
+    if not 0 < height <= 255:
+        sys.exit('%s: unsupported height %d' % (args.bdf, height))
+    parts = (height + 7) // 8
+
+    data = bytearray()
+    table = []
+    raw_size = 0
+    for code in range(args.first, args.last + 1):
+        glyph = font['glyphs'].get(code)
+        if glyph is None:
+            table.append((len(data), 0, 0, 0, code))
+            continue
+
+        pixels = [(x, y) for x, y in glyph_pixels(font, glyph) if 0 <= y < height]
+        advance = glyph.get('advance', 0) + args.spacing
+        if not pixels:
+            table.append((len(data), 0, advance, 0, code))
+            continue
+
+        left = min(x for x, y in pixels)
+        width = max(x for x, y in pixels) - left + 1
+        columns = bytearray(width * parts)
+        for x, y in pixels:
+            columns[(x - left) * parts + (y >> 3)] |= 1 << (y & 7)
+
+        if width > 255 or advance > 255 or not -128 <= left <= 127:
+            sys.exit('%s: glyph %d is too large' % (args.bdf, code))
+        table.append((len(data), width, advance, left, code))
+        raw_size += len(columns)
+        data += encode_rle(columns) if args.compress else columns
+
+    if len(data) > 0xFFFF:
+        sys.exit('%s: %d bytes of glyph data, at most 65535 are supported' % (args.bdf, len(data)))
+
+    out = []
+    out.append('/*')
+    out.append('  Generated by tools/bdf_font_converter.py from %s, height %d, %d bytes%s'
+               % (args.bdf, height, len(data), ' compressed' if args.compress else ''))
+    out.append('*/')
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('#include <stdint.h>')
+    out.append('#include "cilo72/fonts/proportional_font.h"')
+    out.append('')
+    out.append('namespace %s' % args.namespace)
+    out.append('{')
+    out.append('    inline constexpr uint8_t %s_data[] = {' % args.name)
+    for i in range(0, len(data), 16):
+        out.append('        ' + ', '.join('0x%02X' % b for b in data[i:i + 16]) + ',')
+    if not data:
+        out.append('        0x00,')
+    out.append('    };')
+    out.append('')
+    out.append('    inline constexpr cilo72::fonts::ProportionalFont::Glyph %s_glyphs[] = {' % args.name)
+    for offset, width, advance, left, code in table:
+        char = chr(code) if 32 < code < 127 and chr(code) not in '\\' else '0x%02X' % code
+        out.append('        {%d, %d, %d, %d}, // %s' % (offset, width, advance, left, char))
+    out.append('    };')
+    out.append('')
+    out.append('    inline constexpr cilo72::fonts::ProportionalFont %s(%d, %d, %d, %s_glyphs, %s_data%s);'
+               % (args.name, height, args.first, args.last, args.name, args.name, ', true' if args.compress else ''))
+    out.append('}')
+    out.append('')
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write('\n'.join(out))
+    else:
+        sys.stdout.write('\n'.join(out))
+
+    print('%s: height %d, %d glyphs, %d bytes (%d uncompressed, %d at full cell width)'
+          % (args.name, height, len(table), len(data), raw_size,
+             len(table) * parts * max([t[2] for t in table] + [1])), file=sys.stderr)
+
+    if args.compress and len(data) >= raw_size:
+        print('%s: the compressed glyphs are not smaller, consider converting without --compress' % args.name,
+              file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
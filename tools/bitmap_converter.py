@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Daniel Zwirner
+# SPDX-License-Identifier: MIT-0
+#
+# Convert an image to a C++ header with a cilo72::graphic::Bitmap for Framebuffer::blit().
+#
+#   tools/bitmap_converter.py logo.png logo -f rle565 -o src/assets/logo.h
+#   tools/bitmap_converter.py splash.png splash -f qoi -o src/assets/splash.h
+#
+# Formats (see src/cilo72/graphic/bitmap.h):
+#   rgb565  raw pixels, 2 bytes each, high byte first
+#   rle565  run length encoded RGB565, usually a fraction of the raw size for icons and splash screens
+#   mono    1 bit per pixel, set for dark (or with --invert light) opaque pixels
+#   qoi     a QOI file as byte array for cilo72::graphic::QoiDecoder, e.g. ST7735S::drawImage() without framebuffer
+#
+# Transparent pixels (alpha < 128) of color bitmaps are replaced by the color key, which defaults to magenta.
+# Opaque pixels with the value of the key are changed by one bit of blue, so they stay visible.
+
+import argparse
+import sys
+
+from PIL import Image
+
+
+def rgb565(r, g, b):
+    return (r >> 3) << 11 | (g >> 2) << 5 | (b >> 3)
+
+
+def color_pixels(image, key):
+    pixels = []
+    transparent = False
+    for r, g, b, a in image.getdata():
+        if a < 128:
+            pixels.append(key)
+            transparent = True
+        else:
+            value = rgb565(r, g, b)
+            pixels.append(value ^ 1 if value == key else value)
+    return pixels, transparent
+
+
+def encode_raw(pixels):
+    data = bytearray()
+    for value in pixels:
+        data += bytes((value >> 8, value & 0xFF))
+    return data
+
+
+def encode_rle(pixels):
+    data = bytearray()
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < 128 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            data.append(0x80 | (run - 1))
+            data += encode_raw(pixels[i:i + 1])
+            i += run
+            continue
+
+        start = i
+        while i < len(pixels) and i - start < 128:
+            if i + 1 < len(pixels) and pixels[i + 1] == pixels[i]:
+                break
+            i += 1
+        data.append(i - start - 1)
+        data += encode_raw(pixels[start:i])
+    return data
+
+
+def encode_qoi(image):
+    width, height = image.size
+    data = bytearray(b'qoif')
+    data += width.to_bytes(4, 'big') + height.to_bytes(4, 'big') + bytes((4, 0))
+
+    index = [(0, 0, 0, 0)] * 64
+    previous = (0, 0, 0, 255)
+    run = 0
+    pixels = list(image.getdata())
+    for i, pixel in enumerate(pixels):
+        if pixel == previous:
+            run += 1
+            if run == 62 or i == len(pixels) - 1:
+                data.append(0xC0 | (run - 1))
+                run = 0
+            continue
+
+        if run > 0:
+            data.append(0xC0 | (run - 1))
+            run = 0
+
+        r, g, b, a = pixel
+        hash_index = (r * 3 + g * 5 + b * 7 + a * 11) % 64
+        if index[hash_index] == pixel:
+            data.append(hash_index)
+        else:
+            index[hash_index] = pixel
+            if a != previous[3]:
+                data += bytes((0xFF, r, g, b, a))
+            else:
+                dr = (r - previous[0] + 128) % 256 - 128
+                dg = (g - previous[1] + 128) % 256 - 128
+                db = (b - previous[2] + 128) % 256 - 128
+                if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                    data.append(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+                elif -32 <= dg <= 31 and -8 <= dr - dg <= 7 and -8 <= db - dg <= 7:
+                    data += bytes((0x80 | (dg + 32), (dr - dg + 8) << 4 | (db - dg + 8)))
+                else:
+                    data += bytes((0xFE, r, g, b))
+        previous = pixel
+
+    data += bytes(7) + bytes((1,))
+    return data
+
+
+def encode_mono(image, invert):
+    width, height = image.size
+    data = bytearray()
+    pixels = list(image.getdata())
+    for y in range(height):
+        row = bytearray((width + 7) // 8)
+        for x in range(width):
+            r, g, b, a = pixels[y * width + x]
+            dark = (r * 299 + g * 587 + b * 114) // 1000 < 128
+            if a >= 128 and dark != invert:
+                row[x >> 3] |= 0x80 >> (x & 7)
+        data += row
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert an image to a cilo72::graphic::Bitmap header')
+    parser.add_argument('image', help='input image, any format supported by Pillow')
+    parser.add_argument('name', help='name of the C++ constant')
+    parser.add_argument('-f', '--format', choices=['rgb565', 'rle565', 'mono', 'qoi'], default='rle565')
+    parser.add_argument('-k', '--key', default='ff00ff', help='transparent color as RRGGBB (default ff00ff)')
+    parser.add_argument('-n', '--namespace', default='assets', help='C++ namespace (default assets)')
+    parser.add_argument('-i', '--invert', action='store_true', help='mono: set bits for light pixels')
+    parser.add_argument('-o', '--output', help='output header, default stdout')
+    args = parser.parse_args()
+
+    image = Image.open(args.image).convert('RGBA')
+    width, height = image.size
+    key = int(args.key, 16)
+    key = rgb565(key >> 16, (key >> 8) & 0xFF, key & 0xFF)
+
+    transparent = False
+    if args.format == 'qoi':
+        data = encode_qoi(image)
+        fmt = 'QOI'
+    elif args.format == 'mono':
+        data = encode_mono(image, args.invert)
+        fmt = 'Monochrome'
+    else:
+        pixels, transparent = color_pixels(image, key)
+        if args.format == 'rgb565':
+            data = encode_raw(pixels)
+            fmt = 'RGB565'
+        else:
+            data = encode_rle(pixels)
+            fmt = 'RLE565'
+
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append('        ' + ', '.join('0x%02X' % b for b in data[i:i + 16]) + ',')
+
+    out = []
+    out.append('/*')
+    out.append('  Generated by tools/bitmap_converter.py from %s, %dx%d, %d bytes' % (args.image, width, height, len(data)))
+    out.append('*/')
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('#include <stdint.h>')
+    if fmt != 'QOI':
+        out.append('#include "cilo72/graphic/bitmap.h"')
+    out.append('')
+    out.append('namespace %s' % args.namespace)
+    out.append('{')
+    if fmt == 'QOI':
+        # decoded with cilo72::graphic::QoiDecoder decoder(name, sizeof(name))
+        out.append('    inline constexpr uint8_t %s[] = {' % args.name)
+        out.extend(lines)
+        out.append('    };')
+    else:
+        out.append('    inline constexpr uint8_t %s_data[] = {' % args.name)
+        out.extend(lines)
+        out.append('    };')
+        out.append('')
+        out.append('    inline constexpr cilo72::graphic::Bitmap %s(cilo72::graphic::Bitmap::Format::%s, %d, %d, %s_data%s);'
+                   % (args.name, fmt, width, height, args.name, ', 0x%04X' % key if transparent else ''))
+    out.append('}')
+    out.append('')
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write('\n'.join(out))
+    else:
+        sys.stdout.write('\n'.join(out))
+
+    print('%s: %dx%d %s %d bytes (RGB565 %d bytes)' % (args.name, width, height, fmt, len(data), width * height * 2),
+          file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,123 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host micro benchmark of the RGB565 blend kernels of PixelFormatRGB565 against a per channel blend
+  with divisions, as it would be written without the packed kernels.
+
+    g++ -std=c++17 -O2 -I src tools/blend_benchmark.cpp -o blend_benchmark && ./blend_benchmark
+
+  The absolute numbers are host numbers. On the Cortex-M0+ the gap is larger, it has no divide instruction
+  and every division is a call into the runtime library.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "cilo72/graphic/framebuffer_rgb565.h"
+
+using cilo72::graphic::PixelFormatRGB565;
+
+namespace
+{
+  constexpr uint32_t WIDTH = 160;
+  constexpr uint32_t HEIGHT = 128;
+  constexpr int ROUNDS = 200;
+
+  uint16_t blendNaive(uint16_t dst, uint16_t src, uint8_t alpha)
+  {
+    uint32_t r = ((src >> 11) * alpha + (dst >> 11) * (255 - alpha)) / 255;
+    uint32_t g = (((src >> 5) & 0x3F) * alpha + ((dst >> 5) & 0x3F) * (255 - alpha)) / 255;
+    uint32_t b = ((src & 0x1F) * alpha + (dst & 0x1F) * (255 - alpha)) / 255;
+    return r << 11 | g << 5 | b;
+  }
+
+  // volatile, so the compiler can not replace the divisions by 255 with multiplications
+  volatile uint32_t divisor = 255;
+
+  uint16_t blendNaiveDivide(uint16_t dst, uint16_t src, uint8_t alpha)
+  {
+    uint32_t r = ((src >> 11) * alpha + (dst >> 11) * (255 - alpha)) / divisor;
+    uint32_t g = (((src >> 5) & 0x3F) * alpha + ((dst >> 5) & 0x3F) * (255 - alpha)) / divisor;
+    uint32_t b = ((src & 0x1F) * alpha + (dst & 0x1F) * (255 - alpha)) / divisor;
+    return r << 11 | g << 5 | b;
+  }
+
+  template <class F>
+  double measure(F f)
+  {
+    double best = 1e30;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      best = ns < best ? ns : best;
+    }
+    return best / (WIDTH * HEIGHT);
+  }
+
+  int channelError(uint16_t a, uint16_t b)
+  {
+    int error = 0;
+    int d[3] = {(a >> 11) - (b >> 11), ((a >> 5) & 0x3F) - ((b >> 5) & 0x3F), (a & 0x1F) - (b & 0x1F)};
+    for (int i = 0; i < 3; ++i)
+    {
+      error = abs(d[i]) > error ? abs(d[i]) : error;
+    }
+    return error;
+  }
+}
+
+int main()
+{
+  static uint16_t buffer[WIDTH * HEIGHT];
+  static uint8_t coverage[WIDTH * HEIGHT];
+  srand(1);
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i)
+  {
+    buffer[i] = rand();
+    coverage[i] = rand();
+  }
+
+  const uint16_t color = 0xFD20;
+  const uint8_t alpha = 100;
+  uint8_t *bytes = (uint8_t *)buffer;
+
+  double naiveRect = measure([&] {
+    for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i)
+    {
+      buffer[i] = blendNaiveDivide(buffer[i], color, alpha);
+    }
+  });
+  double swarRect = measure([&] { PixelFormatRGB565::blendRect(bytes, WIDTH, 0, 0, WIDTH, HEIGHT, alpha, color, false); });
+
+  double naiveSpan = measure([&] {
+    for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i)
+    {
+      buffer[i] = blendNaiveDivide(buffer[i], color, coverage[i]);
+    }
+  });
+  double swarSpan = measure([&] {
+    for (uint32_t y = 0; y < HEIGHT; ++y)
+    {
+      PixelFormatRGB565::blendSpan(bytes, WIDTH, 0, y, WIDTH, coverage + y * WIDTH, color, false);
+    }
+  });
+
+  int maxError = 0;
+  for (uint32_t dst = 0; dst < 0x10000; dst += 7)
+  {
+    for (uint32_t a = 0; a < 256; ++a)
+    {
+      int error = channelError(PixelFormatRGB565::blend(dst, color, a), blendNaive(dst, color, a));
+      maxError = error > maxError ? error : maxError;
+    }
+  }
+
+  printf("constant alpha   naive %6.2f ns/pixel   packed, 2 pixels per word %6.2f ns/pixel   %.1fx\n", naiveRect, swarRect, naiveRect / swarRect);
+  printf("coverage         naive %6.2f ns/pixel   packed, 1 pixel per word  %6.2f ns/pixel   %.1fx\n", naiveSpan, swarSpan, naiveSpan / swarSpan);
+  printf("maximum difference to the exact blend: %d LSB per channel\n", maxError);
+  return 0;
+}
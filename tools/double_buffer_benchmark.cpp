@@ -0,0 +1,218 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host harness of the background transfer of ST7735S. The driver is compiled against the stubs in tools/host,
+  ThreadTransfer implements cilo72::hw::AsyncTransfer with a thread that holds the buffer for the time an SPI at
+  the given clock needs to send it. A 160x128 frame is rendered into ST7735S::framebuffer() and sent with
+  ST7735S::swap(), so the measured sequence is the one of the driver: startFlush() and the waitFlush() in front
+  of every command. With one buffer the application waits for the end of the transfer before it renders the
+  next frame, with double buffering it renders into the other buffer meanwhile. The tool reports the frame time
+  of both and how much of the rendering overlapped with the transfer.
+
+  The host renders far faster than the RP2040, so the frame is drawn repeatedly until rendering takes the given
+  percentage of the transfer time, by default as long as the transfer.
+
+  The transfer thread checks that the buffer did not change while it was sent. A changed buffer means a torn
+  frame on the display, the tool then exits with 1.
+
+    g++ -std=c++17 -O2 -pthread -I tools/host -I src tools/double_buffer_benchmark.cpp src/cilo72/ic/st7735s.cpp \
+        src/cilo72/graphic/framebuffer.cpp src/cilo72/graphic/framebuffer_rgb565.cpp \
+        src/cilo72/graphic/framebuffer_indexed.cpp src/cilo72/graphic/display_list.cpp \
+        src/cilo72/graphic/qoi_decoder.cpp src/cilo72/graphic/glyph_cache.cpp src/cilo72/fonts/font_8x5.cpp \
+        -o double_buffer_benchmark
+    ./double_buffer_benchmark [SPI clock in MHz, default 62.5] [render time in % of the transfer, default 100]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "cilo72/ic/st7735s.h"
+
+using cilo72::graphic::Color;
+using cilo72::graphic::FramebufferRGB565;
+using cilo72::ic::ST7735S;
+
+namespace
+{
+  constexpr uint PIN_DC = 8;
+  constexpr uint PIN_RST = 9;
+  constexpr uint PIN_BL = 10;
+  constexpr uint16_t WIDTH = 160;
+  constexpr uint16_t HEIGHT = 128;
+  constexpr int FRAMES = 100;
+
+  using Clock = std::chrono::steady_clock;
+
+  uint32_t checksum(const uint8_t *data, size_t len)
+  {
+    uint32_t sum = 2166136261u;
+    for (size_t i = 0; i < len; ++i)
+    {
+      sum = (sum ^ data[i]) * 16777619u;
+    }
+    return sum;
+  }
+
+  class ThreadTransfer : public cilo72::hw::AsyncTransfer
+  {
+  public:
+    explicit ThreadTransfer(double bytesPerSecond)
+        : bytesPerSecond_(bytesPerSecond), busy_(false), torn_(0), transferred_(0)
+    {
+    }
+
+    ~ThreadTransfer() override
+    {
+      join();
+    }
+
+    void start(const uint8_t *tx, size_t len) override
+    {
+      join();
+      busy_ = true;
+      thread_ = std::thread([this, tx, len]
+                            {
+        // sleep instead of spin, so the transfer does not take the CPU from the rendering like the DMA
+        auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(len / bytesPerSecond_));
+        uint32_t before = checksum(tx, len);
+        std::this_thread::sleep_until(end);
+        torn_ += checksum(tx, len) != before;
+        transferred_ += len;
+        busy_ = false; });
+    }
+
+    bool busy() override
+    {
+      return busy_;
+    }
+
+    uint32_t torn() const { return torn_; }
+    uint64_t transferred() const { return transferred_; }
+
+  private:
+    void join()
+    {
+      if (thread_.joinable())
+      {
+        thread_.join();
+      }
+    }
+
+    double bytesPerSecond_;
+    std::atomic<bool> busy_;
+    std::atomic<uint32_t> torn_;
+    std::atomic<uint64_t> transferred_;
+    std::thread thread_;
+  };
+
+  int passes = 1;
+
+  // a frame with a moving bar, a grid and text, drawn completely every time
+  void draw(FramebufferRGB565 &fb, int frame)
+  {
+    fb.clear(Color(0, 0, 40));
+    for (int x = 0; x < WIDTH; x += 10)
+    {
+      fb.drawLine(x, 0, x, HEIGHT - 1, Color(0, 60, 0));
+    }
+    for (int y = 0; y < HEIGHT; y += 10)
+    {
+      fb.drawLine(0, y, WIDTH - 1, y, Color(0, 60, 0));
+    }
+    fb.drawSquare(frame % WIDTH, 40, 20, 48, Color(255, 128, 0));
+    fb.drawCircle(80, 64, 20 + frame % 20, Color(0, 160, 255));
+    char text[16];
+    snprintf(text, sizeof(text), "frame %d", frame);
+    fb.drawString(4, 4, 2, text);
+  }
+
+  void render(FramebufferRGB565 &fb, int frame)
+  {
+    for (int i = 0; i < passes; ++i)
+    {
+      draw(fb, frame);
+    }
+  }
+
+  // the number of passes that render a frame in about the given time
+  int calibrate(FramebufferRGB565 &fb, double seconds)
+  {
+    auto start = Clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+      draw(fb, frame);
+    }
+    double once = std::chrono::duration<double>(Clock::now() - start).count() / FRAMES;
+    int n = (int)(seconds / once + 0.5);
+    return n < 1 ? 1 : n;
+  }
+
+  struct Result
+  {
+    double frame;  //< Seconds per frame.
+    double render; //< Seconds of rendering per frame.
+  };
+
+  // renders FRAMES frames into the framebuffer of the display and sends each with swap()
+  Result run(ST7735S &display, bool wait)
+  {
+    double rendering = 0;
+    auto start = Clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+      auto r = Clock::now();
+      render(display.framebuffer(), frame);
+      rendering += std::chrono::duration<double>(Clock::now() - r).count();
+      display.swap();
+      if (wait)
+      {
+        display.waitFlush();
+      }
+    }
+    display.waitFlush();
+    return {std::chrono::duration<double>(Clock::now() - start).count() / FRAMES, rendering / FRAMES};
+  }
+}
+
+int main(int argc, char **argv)
+{
+  double mhz = argc > 1 ? atof(argv[1]) : 62.5;
+  double load = argc > 2 ? atof(argv[2]) : 100;
+  if (mhz <= 0 || load < 0)
+  {
+    printf("usage: %s [SPI clock in MHz] [render time in %% of the transfer]\n", argv[0]);
+    return 2;
+  }
+
+  ThreadTransfer transfer(mhz * 1e6 / 8);
+  FramebufferRGB565 first(WIDTH, HEIGHT);
+  FramebufferRGB565 second(WIDTH, HEIGHT);
+  cilo72::hw::SPIDevice spi(PIN_DC);
+  ST7735S display(first, spi, PIN_DC, PIN_RST, PIN_BL);
+  display.init();
+  double wire = first.bufferSize() / (mhz * 1e6 / 8);
+  passes = calibrate(first, wire * load / 100);
+
+  // one buffer: the second buffer is the first one, the next frame is drawn into the buffer being sent, so
+  // every frame waits for its transfer
+  display.setDoubleBuffer(first, transfer);
+  Result s = run(display, true);
+  display.setDoubleBuffer(second, transfer);
+  Result d = run(display, false);
+
+  // without overlap a frame takes render + transfer, with full overlap the longer of both
+  double shorter = s.render < s.frame - s.render ? s.render : s.frame - s.render;
+  double overlap = (s.frame - d.frame) / shorter;
+  overlap = overlap < 0 ? 0 : (overlap > 1 ? 1 : overlap);
+  printf("SPI %.1f MHz, %u bytes per frame, transfer %.2f ms, %d render passes\n", mhz,
+         (unsigned)first.bufferSize(), wire * 1e3, passes);
+  printf("single buffer  %7.2f ms/frame  %6.1f fps  (render %.2f ms)\n", s.frame * 1e3, 1 / s.frame, s.render * 1e3);
+  printf("double buffer  %7.2f ms/frame  %6.1f fps  (render %.2f ms)\n", d.frame * 1e3, 1 / d.frame, d.render * 1e3);
+  printf("overlap %.0f%% of the shorter phase, %llu bytes transferred, %u torn frames\n", overlap * 100,
+         (unsigned long long)transfer.transferred(), transfer.torn());
+  return transfer.torn() == 0 ? 0 : 1;
+}
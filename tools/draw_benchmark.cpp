@@ -0,0 +1,113 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host micro benchmark of drawPixel(), drawSquare(), drawLine() and drawString() on a 128x64 monochrome
+  framebuffer. It only uses calls that compile with the 8 bit coordinates from before the widening to 16 bit,
+  so the same source measures the tree and older revisions, e.g. the commit that widened the coordinates and
+  its parent. compare() takes the revisions as arguments, it builds them with color.cpp, which revisions from
+  before the colors became header only still have:
+
+    g++ -std=c++17 -O2 -I src tools/draw_benchmark.cpp src/cilo72/graphic/framebuffer.cpp \
+        src/cilo72/graphic/framebuffer_monochrome.cpp src/cilo72/graphic/glyph_cache.cpp \
+        src/cilo72/fonts/font_8x5.cpp -o draw_benchmark && ./draw_benchmark
+
+    compare() {
+      for r in "$@"; do
+        d=$(mktemp -d) && git worktree add --detach "$d" "$r" && g++ -std=c++17 -O2 -I "$d/src" tools/draw_benchmark.cpp \
+          "$d"/src/cilo72/graphic/{framebuffer,framebuffer_monochrome,glyph_cache,color}.cpp \
+          "$d/src/cilo72/fonts/font_8x5.cpp" -o "$d/draw_benchmark" && "$d/draw_benchmark"
+        git worktree remove --force "$d"
+      done
+    }
+    compare <commit of the widening>~1 <commit of the widening>
+
+  All primitives stay inside the framebuffer, so all versions draw the same pixels and print the same checksum.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include "cilo72/graphic/framebuffer_monochrome.h"
+
+using cilo72::graphic::Color;
+using cilo72::graphic::FramebufferMonochrome;
+
+namespace
+{
+  constexpr int ROUNDS = 200;
+
+  template <class F>
+  double measure(F f, uint32_t calls)
+  {
+    double best = 1e30;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f(round);
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      best = ns < best ? ns : best;
+    }
+    return best / calls;
+  }
+
+  uint32_t checksum(const FramebufferMonochrome &fb)
+  {
+    uint32_t sum = 2166136261u;
+    for (size_t i = 0; i < fb.bufferSize(); ++i)
+    {
+      sum = (sum ^ fb.buffer()[i]) * 16777619u;
+    }
+    return sum;
+  }
+
+  Color color(int round)
+  {
+    return round & 1 ? Color::white : Color(0, 0, 0);
+  }
+}
+
+int main()
+{
+  FramebufferMonochrome fb(128, 64);
+  fb.clear();
+
+  double pixel = measure([&](int round) {
+    for (uint32_t y = 0; y < 64; ++y)
+    {
+      for (uint32_t x = 0; x < 128; ++x)
+      {
+        fb.drawPixel(x, y, color(round + x + y));
+      }
+    }
+  }, 128 * 64);
+
+  double square = measure([&](int round) {
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+      fb.drawSquare(i * 3, i, 20 + i, 16, color(round + i));
+    }
+  }, 32);
+
+  double line = measure([&](int round) {
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+      fb.drawLine(i * 4, 0, 127 - i * 4, 63, color(round + i));
+      fb.drawLine(0, i * 2, 127, 63 - i * 2, color(round + i));
+    }
+  }, 64);
+
+  double string = measure([&](int round) {
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+      fb.drawString(0, i * 8, 1, "The quick brown fox", color(round + i));
+    }
+  }, 8);
+
+  printf("drawPixel    %8.2f ns/call\n", pixel);
+  printf("drawSquare   %8.2f ns/call  (avg 36x16)\n", square);
+  printf("drawLine     %8.2f ns/call  (127x63)\n", line);
+  printf("drawString   %8.2f ns/call  (19 characters)\n", string);
+  printf("checksum     %08x\n", checksum(fb));
+  return 0;
+}
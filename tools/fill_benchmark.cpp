@@ -0,0 +1,127 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host micro benchmark of the span and rectangle fill hooks of FramebufferRGB565 and FramebufferMonochrome
+  against the per pixel defaults of Framebuffer, which call setPixel() for every pixel like drawSquare() did
+  before the hooks. Both framebuffers draw the same squares, the tool exits with 1 if the pixels differ.
+
+    g++ -std=c++17 -O2 -I src tools/fill_benchmark.cpp src/cilo72/graphic/framebuffer.cpp \
+        src/cilo72/graphic/framebuffer_rgb565.cpp src/cilo72/graphic/framebuffer_monochrome.cpp \
+        src/cilo72/graphic/glyph_cache.cpp src/cilo72/fonts/font_8x5.cpp -o fill_benchmark && ./fill_benchmark
+
+  The absolute numbers are host numbers. On the Cortex-M0+ a virtual call per pixel costs more relative to
+  a word store, so the gap is larger.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "cilo72/graphic/framebuffer_rgb565.h"
+#include "cilo72/graphic/framebuffer_monochrome.h"
+
+using cilo72::graphic::Color;
+using cilo72::graphic::Framebuffer;
+using cilo72::graphic::FramebufferMonochrome;
+using cilo72::graphic::FramebufferRGB565;
+
+namespace
+{
+  constexpr int ROUNDS = 200;
+
+  // the framebuffer without its fill hooks, every pixel goes through setPixel()
+  template <class Base>
+  class PerPixel : public Base
+  {
+  public:
+    PerPixel(uint16_t width, uint16_t height) : Base(width, height) {}
+
+  protected:
+    void fillSpan(uint32_t x, uint32_t y, uint32_t width, Framebuffer::NativeColor color) override
+    {
+      Framebuffer::fillSpan(x, y, width, color);
+    }
+
+    void fillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Framebuffer::NativeColor color) override
+    {
+      Framebuffer::fillRect(x, y, width, height, color);
+    }
+  };
+
+  struct Case
+  {
+    const char *name;
+    int32_t x;
+    int32_t y;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  template <class F>
+  double measure(F f, uint32_t pixels)
+  {
+    double best = 1e30;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      best = ns < best ? ns : best;
+    }
+    return best / pixels;
+  }
+
+  // draws the cases into both framebuffers, returns false if the pixels differ
+  bool run(const char *format, Framebuffer &hooks, Framebuffer &pixels, const Case *cases, size_t count)
+  {
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+      const Case &c = cases[i];
+      hooks.clear();
+      pixels.clear();
+
+      // the cases start inside the framebuffer, only the visible pixels count
+      uint32_t visible = ((uint32_t)c.x + c.width > hooks.width() ? hooks.width() - c.x : c.width) *
+                         ((uint32_t)c.y + c.height > hooks.height() ? hooks.height() - c.y : c.height);
+
+      // alternate the colors, so every round writes the pixels
+      int n = 0;
+      double fast = measure([&] { hooks.drawSquare(c.x, c.y, c.width, c.height, ++n & 1 ? Color::white : Color(0, 0, 0)); }, visible);
+      n = 0;
+      double slow = measure([&] { pixels.drawSquare(c.x, c.y, c.width, c.height, ++n & 1 ? Color::white : Color(0, 0, 0)); }, visible);
+
+      bool same = memcmp(hooks.buffer(), pixels.buffer(), hooks.bufferSize()) == 0;
+      ok = ok && same;
+      printf("%-10s %-22s per pixel %7.3f ns/pixel   hooks %7.3f ns/pixel   %7.1fx%s\n", format, c.name, slow, fast,
+             slow / fast, same ? "" : "   MISMATCH");
+    }
+    return ok;
+  }
+}
+
+int main()
+{
+  static const Case rgb565[] = {
+      {"full 160x128", 0, 0, 160, 128},
+      {"rectangle 37x29", 13, 21, 37, 29},
+      {"span 151x1", 3, 40, 151, 1},
+      {"clipped 100x100", 100, 70, 100, 100},
+  };
+  static const Case monochrome[] = {
+      {"full 128x64", 0, 0, 128, 64},
+      {"rectangle 37x29", 13, 21, 37, 29},
+      {"span 121x1", 3, 40, 121, 1},
+      {"clipped 100x100", 60, 30, 100, 100},
+  };
+
+  FramebufferRGB565 rgbHooks(160, 128);
+  PerPixel<FramebufferRGB565> rgbPixels(160, 128);
+  FramebufferMonochrome monoHooks(128, 64);
+  PerPixel<FramebufferMonochrome> monoPixels(128, 64);
+
+  bool ok = run("RGB565", rgbHooks, rgbPixels, rgb565, sizeof(rgb565) / sizeof(rgb565[0]));
+  ok = run("monochrome", monoHooks, monoPixels, monochrome, sizeof(monochrome) / sizeof(monochrome[0])) && ok;
+  return ok ? 0 : 1;
+}
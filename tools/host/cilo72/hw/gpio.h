@@ -0,0 +1,68 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host stub of cilo72::hw::Gpio for the tools, the output levels are kept per pin.
+*/
+
+#pragma once
+
+#include "pico/stdlib.h"
+
+namespace cilo72
+{
+    namespace hw
+    {
+        class Gpio
+        {
+        public:
+            enum class Direction
+            {
+                Output,
+                Input
+            };
+
+            enum class Level
+            {
+                Low,
+                High
+            };
+
+            enum class Pull
+            {
+                None,
+                Up,
+                Down
+            };
+
+            static constexpr uint PINS = 32;
+
+            Gpio(uint pin, Direction, Pull, Level level = Level::Low)
+                : pin_(pin)
+            {
+                set(level);
+            }
+
+            Gpio(uint pin, Direction direction, Level level = Level::Low)
+                : Gpio(pin, direction, Pull::None, level)
+            {
+            }
+
+            void set(Level level) const { levels_[pin_] = level == Level::High; }
+            void set() const { levels_[pin_] = true; }
+            void clear() const { levels_[pin_] = false; }
+            void toggle() const { levels_[pin_] = not levels_[pin_]; }
+            bool get() const { return levels_[pin_]; }
+            bool isHigh() const { return levels_[pin_]; }
+
+            /**
+             * @brief Get the output level of a pin.
+             */
+            static bool level(uint pin) { return levels_[pin]; }
+
+        private:
+            uint pin_;
+            static inline bool levels_[PINS] = {};
+        };
+    }
+}
@@ -0,0 +1,37 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host stub of cilo72::hw::Pwm for the tools, it does nothing.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+namespace cilo72
+{
+    namespace hw
+    {
+        class Pwm
+        {
+        public:
+            enum class Operation
+            {
+                A,
+                B,
+                ALL,
+            };
+
+            Pwm(uint) {}
+            Pwm(uint, uint) {}
+            bool setFrequency(uint32_t) { return true; }
+            bool setDutyCycleU32(uint32_t, Operation = Operation::ALL) const { return true; }
+            bool setDutyCycleDouble(double, Operation = Operation::ALL) const { return true; }
+            void setDutyCycleInCounts(uint16_t, Operation) const {}
+            void enable() const {}
+            void invert(bool) const {}
+        };
+    }
+}
@@ -0,0 +1,73 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host stub of cilo72::hw::SPIDevice for the tools. It records every byte written together with the level of
+  the data/command pin of the display, so a tool can replay the command stream.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "cilo72/hw/gpio.h"
+
+namespace cilo72
+{
+    namespace hw
+    {
+        class SPIDevice
+        {
+        public:
+            /**
+             * @brief A byte on the bus.
+             */
+            struct Byte
+            {
+                uint8_t value;
+                bool data; //< True if the data/command pin was high.
+            };
+
+            /**
+             * @brief Create a recording device.
+             * @param pinDC The data/command pin of the display, sampled for every write.
+             */
+            explicit SPIDevice(uint pinDC) : pinDC_(pinDC) {}
+
+            void xfer(const uint8_t *tx, uint8_t *, size_t len) const { write(tx, len); }
+
+            void write(const uint8_t *tx, size_t len, uint32_t repeat = 1) const
+            {
+                bool data = Gpio::level(pinDC_);
+                for (uint32_t i = 0; i < repeat; ++i)
+                {
+                    for (size_t j = 0; j < len; ++j)
+                    {
+                        bytes_.push_back({tx[j], data});
+                    }
+                }
+            }
+
+            void setFormat(uint, spi_cpol_t, spi_cpha_t) {}
+            void setBaudrate(uint) {}
+            void select() const {}
+            void deselect() const {}
+
+            /**
+             * @brief Get the recorded bytes.
+             */
+            const std::vector<Byte> &bytes() const { return bytes_; }
+
+            /**
+             * @brief Forget the recorded bytes.
+             */
+            void clear() { bytes_.clear(); }
+
+        private:
+            uint pinDC_;
+            mutable std::vector<Byte> bytes_;
+        };
+    }
+}
@@ -0,0 +1,17 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host stub of the Pico SDK for the tools, only what the display drivers use.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+inline void sleep_ms(uint32_t)
+{
+}
@@ -0,0 +1,218 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host benchmark of the QOI decoder: decodes images in chunks of 64 pixels like ST7735S::drawImage() and reports
+  the throughput. Without arguments it encodes two synthetic 160x128 images, a photo like gradient with noise and
+  a screen with flat areas and text like edges. QOI files given as arguments are measured as well. The synthetic
+  images are compared with their source pixels, the tool exits with 1 on a mismatch or an invalid or truncated file.
+
+    g++ -std=c++17 -O2 -I src tools/qoi_benchmark.cpp src/cilo72/graphic/qoi_decoder.cpp -o qoi_benchmark
+    ./qoi_benchmark [image.qoi ...]
+
+  The SPI of the display moves about 1.9 Mpixel/s at 62.5 MHz, the decoder has to stay above that on the target.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "cilo72/graphic/qoi_decoder.h"
+
+using cilo72::graphic::QoiDecoder;
+
+namespace
+{
+  constexpr uint32_t WIDTH = 160;
+  constexpr uint32_t HEIGHT = 128;
+  constexpr uint32_t CHUNK = 64;
+  constexpr int ROUNDS = 200;
+
+  struct Pixel
+  {
+    uint8_t r, g, b, a;
+    bool operator==(const Pixel &rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b && a == rhs.a; }
+  };
+
+  void put32(std::vector<uint8_t> &out, uint32_t v)
+  {
+    out.insert(out.end(), {(uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v});
+  }
+
+  // the encoder of tools/bitmap_converter.py
+  std::vector<uint8_t> encode(const std::vector<Pixel> &pixels, uint32_t width, uint32_t height)
+  {
+    std::vector<uint8_t> out = {'q', 'o', 'i', 'f'};
+    put32(out, width);
+    put32(out, height);
+    out.push_back(4);
+    out.push_back(0);
+
+    Pixel index[64] = {};
+    Pixel previous = {0, 0, 0, 255};
+    int run = 0;
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+      const Pixel &p = pixels[i];
+      if (p == previous)
+      {
+        if (++run == 62 || i == pixels.size() - 1)
+        {
+          out.push_back(0xC0 | (run - 1));
+          run = 0;
+        }
+        continue;
+      }
+
+      if (run > 0)
+      {
+        out.push_back(0xC0 | (run - 1));
+        run = 0;
+      }
+
+      int h = (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64;
+      if (index[h] == p)
+      {
+        out.push_back(h);
+      }
+      else
+      {
+        index[h] = p;
+        int dr = (int8_t)(p.r - previous.r);
+        int dg = (int8_t)(p.g - previous.g);
+        int db = (int8_t)(p.b - previous.b);
+        if (p.a != previous.a)
+        {
+          out.insert(out.end(), {0xFF, p.r, p.g, p.b, p.a});
+        }
+        else if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+        {
+          out.push_back(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+        }
+        else if (dg >= -32 && dg <= 31 && dr - dg >= -8 && dr - dg <= 7 && db - dg >= -8 && db - dg <= 7)
+        {
+          out.push_back(0x80 | (dg + 32));
+          out.push_back((dr - dg + 8) << 4 | (db - dg + 8));
+        }
+        else
+        {
+          out.insert(out.end(), {0xFE, p.r, p.g, p.b});
+        }
+      }
+      previous = p;
+    }
+
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+    return out;
+  }
+
+  std::vector<Pixel> photo()
+  {
+    std::vector<Pixel> pixels;
+    srand(1);
+    for (uint32_t y = 0; y < HEIGHT; ++y)
+    {
+      for (uint32_t x = 0; x < WIDTH; ++x)
+      {
+        int noise = rand() % 7 - 3;
+        pixels.push_back({(uint8_t)(x + noise), (uint8_t)(y * 2 + noise), (uint8_t)((x + y) / 2 + noise), 255});
+      }
+    }
+    return pixels;
+  }
+
+  std::vector<Pixel> screen()
+  {
+    std::vector<Pixel> pixels;
+    for (uint32_t y = 0; y < HEIGHT; ++y)
+    {
+      for (uint32_t x = 0; x < WIDTH; ++x)
+      {
+        bool bar = y < 16;
+        bool glyph = y > 40 && y < 52 && ((x * 7 + y * 3) % 11) < 4;
+        Pixel p = bar ? Pixel{0, 64, 160, 255} : (glyph ? Pixel{255, 255, 255, 255} : Pixel{16, 16, 24, 255});
+        pixels.push_back(p);
+      }
+    }
+    return pixels;
+  }
+
+  // returns false if the image is invalid, truncated or differs from the reference
+  bool measure(const char *name, const std::vector<uint8_t> &data, const std::vector<Pixel> *reference)
+  {
+    QoiDecoder decoder(data.data(), data.size());
+    if (not decoder.valid())
+    {
+      printf("%-10s not a QOI image\n", name);
+      return false;
+    }
+
+    uint32_t pixels = decoder.width() * decoder.height();
+    std::vector<uint8_t> out(pixels * 2);
+    double best = 1e30;
+    size_t n = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+      decoder.rewind();
+      auto start = std::chrono::steady_clock::now();
+      n = 0;
+      while (decoder.remaining() > 0)
+      {
+        size_t count = decoder.read(out.data() + n * 2, CHUNK);
+        if (count == 0)
+        {
+          break;
+        }
+        n += count;
+      }
+      double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      best = s < best ? s : best;
+    }
+
+    bool ok = n == pixels;
+    if (ok && reference)
+    {
+      for (uint32_t i = 0; i < pixels; ++i)
+      {
+        const Pixel &p = (*reference)[i];
+        uint16_t value = (p.r >> 3) << 11 | (p.g >> 2) << 5 | p.b >> 3;
+        ok = ok && out[2 * i] == value >> 8 && out[2 * i + 1] == (value & 0xFF);
+      }
+    }
+
+    printf("%-10s %4ux%-4u %6zu bytes (%4.1f%% of RGB565)  %7.1f Mpixel/s  %7.1f MB/s RGB565%s\n", name, decoder.width(), decoder.height(),
+           data.size(), 100.0 * data.size() / (pixels * 2), pixels / best / 1e6, pixels * 2 / best / 1e6, ok ? "" : (n < pixels ? "  TRUNCATED" : "  MISMATCH"));
+    return ok;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<Pixel> p = photo();
+  std::vector<Pixel> s = screen();
+  bool ok = measure("photo", encode(p, WIDTH, HEIGHT), &p);
+  ok = measure("screen", encode(s, WIDTH, HEIGHT), &s) && ok;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    FILE *f = fopen(argv[i], "rb");
+    if (f == nullptr)
+    {
+      printf("%s: can not open\n", argv[i]);
+      ok = false;
+      continue;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    {
+      data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    ok = measure(argv[i], data, nullptr) && ok;
+  }
+  return ok ? 0 : 1;
+}
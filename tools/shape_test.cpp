@@ -0,0 +1,384 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host test of the filled shapes of Framebuffer and BasicFramebuffer. Random circles, ellipses, rounded squares,
+  polygons and arcs, partly outside the framebuffer, inside random viewports and clip rectangles, are compared
+  pixel by pixel with a brute force evaluation of the shape for every pixel. Small scenes of every shape are
+  compared with golden images. The dirty region has to contain the drawn pixels and BasicFramebuffer has to draw
+  the same pixels as FramebufferRGB565. The tool exits with 1 on the first mismatches.
+
+    g++ -std=c++17 -O2 -I src tools/shape_test.cpp src/cilo72/graphic/framebuffer.cpp \
+        src/cilo72/graphic/framebuffer_rgb565.cpp src/cilo72/graphic/glyph_cache.cpp \
+        src/cilo72/fonts/font_8x5.cpp -o shape_test && ./shape_test [iterations, default 20000]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <functional>
+#include "cilo72/graphic/framebuffer_rgb565.h"
+#include "cilo72/graphic/basic_framebuffer.h"
+
+using cilo72::graphic::Color;
+using cilo72::graphic::FramebufferRGB565;
+using cilo72::graphic::Point;
+using cilo72::graphic::Rect;
+using cilo72::graphic::StaticFramebufferRGB565;
+
+namespace
+{
+  constexpr int WIDTH = 96;
+  constexpr int HEIGHT = 80;
+  constexpr int MAX_FAILURES = 10;
+
+  // true if the pixel is part of the shape, in framebuffer coordinates
+  using Shape = std::function<bool(int32_t, int32_t)>;
+
+  int failures = 0;
+
+  // the Q14 sine of whole degrees, the same values as the table of the rasterizer
+  int64_t sine(int32_t degrees)
+  {
+    degrees %= 360;
+    return lround(16384 * sin((degrees < 0 ? degrees + 360 : degrees) * M_PI / 180));
+  }
+
+  // the pixel centers inside the ellipse through the outer edges of the pixels at h = +-a and k = +-b
+  bool insideEllipse(int64_t h, int64_t k, int64_t a, int64_t b)
+  {
+    int64_t aa = (2 * a + 1) * (2 * a + 1);
+    int64_t bb = (2 * b + 1) * (2 * b + 1);
+    return 4 * h * h * bb + 4 * k * k * aa <= aa * bb;
+  }
+
+  bool pixel(const FramebufferRGB565 &fb, int32_t x, int32_t y)
+  {
+    const uint8_t *p = fb.buffer() + (y * WIDTH + x) * 2;
+    return p[0] | p[1];
+  }
+
+  void check(const char *name, const FramebufferRGB565 &fb, const Shape &shape, const Rect &clip)
+  {
+    int bad = 0;
+    int32_t left = WIDTH, top = HEIGHT, right = -1, bottom = -1;
+    for (int32_t y = 0; y < HEIGHT; ++y)
+    {
+      for (int32_t x = 0; x < WIDTH; ++x)
+      {
+        bool expected = shape(x, y) && clip.contains(x, y);
+        bool drawn = pixel(fb, x, y);
+        if (expected != drawn && bad++ < 3)
+        {
+          printf("%s: pixel (%d, %d) expected %d, drawn %d\n", name, x, y, expected, drawn);
+        }
+        if (drawn)
+        {
+          left = x < left ? x : left;
+          top = y < top ? y : top;
+          right = x > right ? x : right;
+          bottom = y > bottom ? y : bottom;
+        }
+      }
+    }
+
+    Rect drawn(left, top, right - left + 1, bottom - top + 1);
+    if (right >= 0 && not(fb.dirtyRegion().intersected(drawn) == drawn))
+    {
+      printf("%s: dirty region does not contain the drawn pixels\n", name);
+      ++bad;
+    }
+    failures += bad > 0;
+  }
+
+  template <class F>
+  void draw(FramebufferRGB565 &fb, StaticFramebufferRGB565<WIDTH, HEIGHT> &sfb, F f)
+  {
+    f(fb);
+    f(sfb);
+  }
+
+  void randomShape(FramebufferRGB565 &fb, StaticFramebufferRGB565<WIDTH, HEIGHT> &sfb)
+  {
+    fb.clear();
+    fb.clearDirty();
+    sfb.clear();
+    sfb.clearDirty();
+
+    // the origin of the shapes in framebuffer coordinates and the pixels that may be drawn
+    int32_t vx = 0, vy = 0;
+    Rect clip(0, 0, WIDTH, HEIGHT);
+    bool viewport = rand() % 3 == 0;
+    if (viewport)
+    {
+      vx = rand() % 20 - 5;
+      vy = rand() % 20 - 5;
+      Rect v(vx, vy, rand() % WIDTH + 5, rand() % HEIGHT + 5);
+      fb.pushViewport(v);
+      sfb.pushViewport(v);
+      clip = clip.intersected(v);
+    }
+    if (rand() % 2)
+    {
+      Rect c(rand() % WIDTH - 20, rand() % HEIGHT - 20, rand() % WIDTH, rand() % HEIGHT);
+      fb.setClipRect(c);
+      sfb.setClipRect(c);
+      clip = fb.clipRect();
+    }
+
+    char name[96];
+    Shape shape;
+    int32_t cx = rand() % (WIDTH + 40) - 20;
+    int32_t cy = rand() % (HEIGHT + 40) - 20;
+    int32_t x0 = cx + vx;
+    int32_t y0 = cy + vy;
+    switch (rand() % 5)
+    {
+    case 0:
+    case 1:
+    {
+      int32_t a = rand() % 40;
+      int32_t b = rand() % 2 ? a : rand() % 40;
+      draw(fb, sfb, [&](FramebufferRGB565 &f) { f.drawEllipse(cx, cy, a, b, Color::white); });
+      snprintf(name, sizeof(name), "ellipse %d %d %d %d", cx, cy, a, b);
+      shape = [=](int32_t x, int32_t y) { return insideEllipse(x - x0, y - y0, a, b); };
+      break;
+    }
+    case 2:
+    {
+      int32_t w = rand() % 60, h = rand() % 60, r = rand() % 30;
+      draw(fb, sfb, [&](FramebufferRGB565 &f) { f.drawRoundedSquare(cx, cy, w, h, r, Color::white); });
+      snprintf(name, sizeof(name), "rounded square %d %d %d %d %d", cx, cy, w, h, r);
+
+      // the corners are quarters of a circle with the limited radius, the straight parts are full
+      int32_t rr = r < (w - 1) / 2 ? r : (w - 1) / 2;
+      rr = rr < (h - 1) / 2 ? rr : (h - 1) / 2;
+      shape = [=](int32_t x, int32_t y) {
+        int32_t px = x - x0, py = y - y0;
+        if (px < 0 || py < 0 || px >= w || py >= h)
+        {
+          return false;
+        }
+        int32_t hx = px < rr ? rr - px : (px > w - 1 - rr ? px - (w - 1 - rr) : 0);
+        int32_t hy = py < rr ? rr - py : (py > h - 1 - rr ? py - (h - 1 - rr) : 0);
+        return hx == 0 || hy == 0 || insideEllipse(hx, hy, rr, rr);
+      };
+      break;
+    }
+    case 3:
+    {
+      size_t n = 3 + rand() % 14;
+      Point points[16];
+      for (size_t i = 0; i < n; ++i)
+      {
+        points[i] = {(int16_t)(rand() % (WIDTH + 20) - 10), (int16_t)(rand() % (HEIGHT + 20) - 10)};
+      }
+      if (rand() % 5 == 0)
+      {
+        n = 4;
+        points[0] = {(int16_t)cx, (int16_t)cy};
+        points[1] = {(int16_t)(cx + 10), (int16_t)cy};
+        points[2] = {(int16_t)(cx + 10), (int16_t)(cy + 7)};
+        points[3] = {(int16_t)cx, (int16_t)(cy + 7)};
+      }
+      draw(fb, sfb, [&](FramebufferRGB565 &f) { f.drawPolygon(points, n, Color::white); });
+      snprintf(name, sizeof(name), "polygon with %u vertices", (unsigned)n);
+
+      // even-odd rule with the pixel centers, edges include the top and exclude the bottom end
+      shape = [=](int32_t x, int32_t y) {
+        int32_t px = x - vx, py = y - vy;
+        int crossings = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+          Point p = points[i], q = points[(i + 1) % n];
+          if (p.y == q.y)
+          {
+            continue;
+          }
+          if (p.y > q.y)
+          {
+            Point t = p;
+            p = q;
+            q = t;
+          }
+          int64_t dy = q.y - p.y, dx = q.x - p.x;
+          crossings += py >= p.y && py < q.y && (int64_t)px * dy >= (int64_t)p.x * dy + (int64_t)(py - p.y) * dx;
+        }
+        return crossings & 1;
+      };
+      break;
+    }
+    default:
+    {
+      int32_t r = rand() % 45, t = rand() % 50 + 1, start = rand() % 1000 - 500, sweep = rand() % 420 - 20;
+      sweep = rand() % 5 == 0 ? rand() % 4 * 90 : sweep;
+      draw(fb, sfb, [&](FramebufferRGB565 &f) { f.drawArc(cx, cy, r, t, start, start + sweep, Color::white); });
+      snprintf(name, sizeof(name), "arc %d %d %d %d %d %d", cx, cy, r, t, start, start + sweep);
+
+      // inside the ring and on the clockwise side of the start and the counterclockwise side of the end ray
+      int32_t inner = t < r ? r - t : -1;
+      int64_t sx = sine(start + 90), sy = sine(start), ex = sine(start + sweep + 90), ey = sine(start + sweep);
+      shape = [=](int32_t x, int32_t y) {
+        int64_t px = x - x0, py = y - y0;
+        if (sweep <= 0 || not insideEllipse(px, py, r, r) || (inner >= 0 && insideEllipse(px, py, inner, inner)))
+        {
+          return false;
+        }
+        bool afterStart = sx * py - sy * px >= 0;
+        bool beforeEnd = px * ey - py * ex >= 0;
+        return sweep >= 360 || (sweep <= 180 ? afterStart && beforeEnd : afterStart || beforeEnd);
+      };
+      break;
+    }
+    }
+
+    check(name, fb, shape, clip);
+    if (memcmp(fb.buffer(), sfb.buffer(), fb.bufferSize()) != 0)
+    {
+      printf("%s: BasicFramebuffer draws different pixels\n", name);
+      ++failures;
+    }
+
+    if (viewport)
+    {
+      fb.popViewport();
+      sfb.popViewport();
+    }
+    fb.resetClipRect();
+    sfb.resetClipRect();
+  }
+
+  void golden(const char *name, FramebufferRGB565 &fb, const char *const *rows, int height)
+  {
+    int32_t width = strlen(rows[0]);
+    bool same = true;
+    for (int32_t y = 0; y < height; ++y)
+    {
+      for (int32_t x = 0; x < width; ++x)
+      {
+        same = same && pixel(fb, x, y) == (rows[y][x] == '#');
+      }
+    }
+    if (not same)
+    {
+      printf("%s differs from the golden image, drawn:\n", name);
+      for (int32_t y = 0; y < height; ++y)
+      {
+        for (int32_t x = 0; x < width; ++x)
+        {
+          putchar(pixel(fb, x, y) ? '#' : '.');
+        }
+        putchar('\n');
+      }
+      ++failures;
+    }
+  }
+
+  void goldenImages()
+  {
+    FramebufferRGB565 fb(WIDTH, HEIGHT);
+
+    static const char *const circleArc[] = {
+        "........................",
+        "...#####..........###...",
+        "..#######.........####..",
+        ".#########..........###.",
+        "###########..........###",
+        "###########...........##",
+        "###########...........##",
+        "###########...........##",
+        "###########..........###",
+        ".#########..........###.",
+        "..#######.........####..",
+        "...#####..........###...",
+        "........................",
+        "........................",
+    };
+    fb.clear();
+    fb.drawCircle(5, 6, 5, Color::white);
+    fb.drawArc(18, 6, 5, 2, -90, 90, Color::white);
+    golden("circle and arc", fb, circleArc, 14);
+
+    static const char *const concave[] = {
+        "........................",
+        "........................",
+        "....####................",
+        ".......########.........",
+        "..........############..",
+        "............########....",
+        "...........#######......",
+        "..........#####.........",
+        ".........####...........",
+        ".......####.............",
+        "......##................",
+        ".....#..................",
+        "........................",
+        "........................",
+    };
+    Point points[] = {{1, 1}, {22, 4}, {3, 12}, {12, 5}};
+    fb.clear();
+    fb.drawPolygon(points, 4, Color::white);
+    golden("concave polygon", fb, concave, 14);
+
+    static const char *const rounded[] = {
+        "........................",
+        "...################.....",
+        "..##################....",
+        ".####################...",
+        ".####################...",
+        ".####################...",
+        ".####################...",
+        ".####################...",
+        "..##################....",
+        "...################.....",
+        "........................",
+        "........................",
+        "........................",
+        "........................",
+    };
+    fb.clear();
+    fb.drawRoundedSquare(1, 1, 20, 9, 3, Color::white);
+    golden("rounded square", fb, rounded, 14);
+
+    static const char *const ellipses[] = {
+        "........................",
+        "......#######.......###.",
+        "...#############....###.",
+        "..###############..#####",
+        ".#################.#####",
+        ".#################.#####",
+        ".#################.#####",
+        "..###############..#####",
+        "...#############...#####",
+        "......#######......#####",
+        "....................###.",
+        "....................###.",
+        "........................",
+        "........................",
+    };
+    fb.clear();
+    fb.drawEllipse(9, 5, 8, 4, Color::white);
+    fb.drawEllipse(21, 6, 2, 5, Color::white);
+    golden("ellipses", fb, ellipses, 14);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+
+  goldenImages();
+
+  FramebufferRGB565 fb(WIDTH, HEIGHT);
+  static StaticFramebufferRGB565<WIDTH, HEIGHT> sfb;
+  srand(3);
+  for (int i = 0; i < iterations && failures < MAX_FAILURES; ++i)
+  {
+    randomShape(fb, sfb);
+  }
+
+  printf("%d shapes, %d failures\n", iterations, failures);
+  return failures == 0 ? 0 : 1;
+}
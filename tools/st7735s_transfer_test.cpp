@@ -0,0 +1,189 @@
+/*
+  Copyright (c) 2024 Daniel Zwirner
+  SPDX-License-Identifier: MIT-0
+
+  Host test of the transfer of ST7735S::update() and ST7735S::updateDirty(). The driver is compiled against the
+  stubs in tools/host, the SPI device records every byte with the level of the data/command pin. The bytes are
+  replayed into an emulated frame memory of the controller (CASET, RASET and RAMWR), which has to show the
+  framebuffer after every update. For a small change, updateDirty() has to set the window to the dirty rectangle
+  and send only its pixels. The tool prints the bytes of both and exits with 1 on a mismatch.
+
+    g++ -std=c++17 -O2 -I tools/host -I src tools/st7735s_transfer_test.cpp src/cilo72/ic/st7735s.cpp \
+        src/cilo72/graphic/framebuffer.cpp src/cilo72/graphic/framebuffer_rgb565.cpp \
+        src/cilo72/graphic/framebuffer_indexed.cpp src/cilo72/graphic/display_list.cpp \
+        src/cilo72/graphic/qoi_decoder.cpp src/cilo72/graphic/glyph_cache.cpp src/cilo72/fonts/font_8x5.cpp \
+        -o st7735s_transfer_test && ./st7735s_transfer_test
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "cilo72/ic/st7735s.h"
+
+using cilo72::graphic::Color;
+using cilo72::graphic::FramebufferRGB565;
+using cilo72::graphic::Rect;
+using cilo72::hw::SPIDevice;
+
+namespace
+{
+  constexpr uint PIN_DC = 8;
+  constexpr uint PIN_RST = 9;
+  constexpr uint PIN_BL = 10;
+  constexpr uint16_t WIDTH = 160;
+  constexpr uint16_t HEIGHT = 128;
+
+  int failures = 0;
+
+  void expect(bool ok, const char *what)
+  {
+    if (not ok)
+    {
+      printf("FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  // the frame memory of the controller, written by CASET, RASET and RAMWR in horizontal scan order
+  class Panel
+  {
+  public:
+    static constexpr uint16_t COLUMNS = cilo72::ic::ST7735S::MAX_WIDTH;
+    static constexpr uint16_t ROWS = cilo72::ic::ST7735S::MAX_HEIGHT;
+
+    Panel() : memory_(COLUMNS * ROWS * 2, 0) {}
+
+    // replays the bytes, returns the number of pixel bytes
+    size_t replay(const std::vector<SPIDevice::Byte> &bytes)
+    {
+      size_t pixels = 0;
+      uint8_t command = 0;
+      std::vector<uint8_t> args;
+      for (const SPIDevice::Byte &b : bytes)
+      {
+        if (not b.data)
+        {
+          command = b.value;
+          args.clear();
+          if (command == 0x2C)
+          {
+            x_ = xs_;
+            y_ = ys_;
+            odd_ = false;
+          }
+          continue;
+        }
+
+        if (command == 0x2C)
+        {
+          write(b.value);
+          ++pixels;
+          continue;
+        }
+
+        args.push_back(b.value);
+        if (args.size() == 4 && (command == 0x2A || command == 0x2B))
+        {
+          uint16_t start = args[0] << 8 | args[1];
+          uint16_t end = args[2] << 8 | args[3];
+          (command == 0x2A ? xs_ : ys_) = start;
+          (command == 0x2A ? xe_ : ye_) = end;
+        }
+      }
+      return pixels;
+    }
+
+    // the window of the last CASET and RASET, the right and bottom edge inclusive like the controller
+    Rect window() const { return Rect(xs_, ys_, xe_ - xs_ + 1, ye_ - ys_ + 1); }
+
+    // true if the memory at the given offset shows the framebuffer
+    bool shows(const FramebufferRGB565 &fb, uint16_t x0, uint16_t y0) const
+    {
+      for (uint16_t y = 0; y < fb.height(); ++y)
+      {
+        const uint8_t *memory = memory_.data() + ((y0 + y) * COLUMNS + x0) * 2;
+        if (memcmp(memory, fb.buffer() + y * fb.width() * 2, fb.width() * 2) != 0)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  private:
+    void write(uint8_t value)
+    {
+      if (x_ < COLUMNS && y_ < ROWS)
+      {
+        memory_[(y_ * COLUMNS + x_) * 2 + odd_] = value;
+      }
+      odd_ = not odd_;
+      if (not odd_ && ++x_ > xe_)
+      {
+        x_ = xs_;
+        ++y_;
+      }
+    }
+
+    std::vector<uint8_t> memory_;
+    uint16_t xs_ = 0, xe_ = 0, ys_ = 0, ye_ = 0;
+    uint16_t x_ = 0, y_ = 0;
+    bool odd_ = false;
+  };
+}
+
+int main()
+{
+  FramebufferRGB565 fb(WIDTH, HEIGHT);
+  SPIDevice spi(PIN_DC);
+  cilo72::ic::ST7735S display(fb, spi, PIN_DC, PIN_RST, PIN_BL);
+  display.init();
+  Panel panel;
+
+  // the window of update() is the whole framebuffer, its corner is the offset of the panel
+  fb.clear(Color(0, 0, 64));
+  fb.drawString(4, 4, 2, "update");
+  spi.clear();
+  display.update();
+  size_t full = spi.bytes().size();
+  size_t fullPixels = panel.replay(spi.bytes());
+  Rect window = panel.window();
+  uint16_t x0 = window.x();
+  uint16_t y0 = window.y();
+  expect(window.width() == WIDTH && window.height() == HEIGHT, "update() window is the framebuffer");
+  expect(fullPixels == WIDTH * HEIGHT * 2, "update() sends every pixel once");
+  expect(panel.shows(fb, x0, y0), "panel shows the framebuffer after update()");
+
+  // a small change, only its rectangle is sent
+  Rect change(37, 50, 6, 4);
+  fb.drawSquare(change.x(), change.y(), change.width(), change.height(), Color(255, 128, 0));
+  spi.clear();
+  display.updateDirty();
+  size_t dirty = spi.bytes().size();
+  size_t dirtyPixels = panel.replay(spi.bytes());
+  window = panel.window();
+  expect(window == Rect(x0 + change.x(), y0 + change.y(), change.width(), change.height()), "updateDirty() window is the change");
+  expect(dirtyPixels == (size_t)change.width() * change.height() * 2, "updateDirty() sends only the changed pixels");
+  expect(panel.shows(fb, x0, y0), "panel shows the framebuffer after updateDirty()");
+
+  // a change of whole rows is sent with one write
+  fb.drawLine(0, 100, WIDTH - 1, 101, Color::white);
+  spi.clear();
+  display.updateDirty();
+  size_t rowsPixels = panel.replay(spi.bytes());
+  expect(panel.window() == Rect(x0, y0 + 100, WIDTH, 2), "updateDirty() window of full rows");
+  expect(rowsPixels == WIDTH * 2 * 2, "updateDirty() sends only the changed rows");
+  expect(panel.shows(fb, x0, y0), "panel shows the framebuffer after a full row update");
+
+  // nothing changed, nothing is sent
+  spi.clear();
+  display.updateDirty();
+  expect(spi.bytes().empty(), "updateDirty() without changes sends nothing");
+
+  printf("update()      %6zu bytes (%zu pixel bytes)\n", full, fullPixels);
+  printf("updateDirty() %6zu bytes (%zu pixel bytes) for a %ux%u change, %.1f%% of update()\n", dirty, dirtyPixels,
+         change.width(), change.height(), 100.0 * dirty / full);
+  printf("%d failures\n", failures);
+  return failures == 0 ? 0 : 1;
+}